@@ -55,7 +55,7 @@ public:
     }
 
     // render the mesh
-    void Draw(Shader shader) 
+    void Draw(const Shader &shader)
     {
         // bind appropriate textures
         unsigned int diffuseNr  = 1;
@@ -0,0 +1,504 @@
+// DRIVES THE GAME FOR A FIXED NUMBER OF FRAMES WITH A SCRIPTED WALK THROUGH THE WORLD AND A FIXED deltaTime
+// (OR WITH A RECORDING MADE BY "--record" IN THE WINDOWED GAME),
+// TIMES EVERY FRAME AND WRITES FRAME TIME PERCENTILES, DRAW CALLS AND STATE CHANGES AS JSON
+// ONLY USED BY THE HEADLESS BENCHMARK BUILD (SAMPLE_2_BENCHMARK)
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "InputState.h"
+#include "InputRecording.h"
+#include "RenderState.h"
+#include "RenderQueue.h"
+#include "TextureLoader.h"
+
+// what a run of the benchmark build times: the game, or one of its parts on its own (see the header named next to it)
+enum BenchmarkMode {
+	BENCHMARK_GAME,
+	BENCHMARK_CHASE, // ChaseBenchmark.h
+	BENCHMARK_PROXIMITY, // ProximityBenchmark.h
+	BENCHMARK_BVH, // BvhBenchmark.h
+	BENCHMARK_DXT, // DxtBenchmark.h
+	BENCHMARK_MIPMAP, // MipmapBenchmark.h
+	BENCHMARK_YCOCG, // ColorBenchmark.h
+	BENCHMARK_UNIFORMS, // UniformBenchmark.h
+	BENCHMARK_NORMALS // NormalBenchmark.h
+};
+
+struct BenchmarkOptions
+{
+	// frames that are timed, 0 means 1200 for the script or the whole recording when replaying
+	unsigned int frames;
+	// frames run before timing starts (texture uploads, shader compiles, driver warm up)
+	unsigned int warmupFrames;
+	// game time advanced by every frame
+	float deltaTime;
+	// size of the offscreen framebuffer, a smaller one takes fill rate out of the numbers
+	unsigned int width;
+	unsigned int height;
+	// where the JSON report goes, empty means standard output
+	std::string output;
+	// input recording to play back instead of the script (its clock replaces deltaTime)
+	std::string replay;
+	// save the input of this run, e.g. to turn the script into a recording
+	std::string record;
+	// only run the game's simulation ticks, without creating an OpenGL context
+	bool simulationOnly;
+	// update the world on a worker thread while the previous frame is drawn
+	bool updateThread;
+	// extra chasing creatures and trees to stress the game with
+	unsigned int mobs;
+	unsigned int trees;
+	// worker threads that help the updating thread with the creature systems (see JobSystem.h)
+	unsigned int jobs;
+	// draw everything, even what is outside the view frustum
+	bool noCulling;
+	// draw the static scene cube by cube instead of from its baked mesh (see StaticBatch.h)
+	bool noBatching;
+	// decode every texture file instead of reading compressed ones from the texture cache (see TextureCache.h)
+	bool noTextureCache;
+	// the game, or the one part of it to time instead
+	BenchmarkMode mode;
+
+	BenchmarkOptions(unsigned int width, unsigned int height) : frames(0), warmupFrames(60), deltaTime(1.0f / 60.0f), width(width), height(height), simulationOnly(false), updateThread(false), mobs(0), trees(0), jobs(0), noCulling(false), noBatching(false), noTextureCache(false), mode(BENCHMARK_GAME) {}
+
+	// the options of the README's "Benchmarking the program", returns false on anything else:
+	// --frames N --warmup N --delta SECONDS --size WIDTHxHEIGHT --output FILE --replay FILE --record FILE
+	// --simulation --update-thread --mobs N --trees N --jobs N --no-cull --no-batch --no-texture-cache
+	// and at most one mode: --chase --proximity --bvh --dxt --mipmap --ycocg --uniforms --normals
+	bool parse(int argc, char **argv)
+	{
+		for(int i = 1; i < argc; i++)
+		{
+			bool hasValue = i + 1 < argc;
+			if(!strcmp(argv[i], "--frames") && hasValue)
+				frames = atoi(argv[++i]);
+			else if(!strcmp(argv[i], "--warmup") && hasValue)
+				warmupFrames = atoi(argv[++i]);
+			else if(!strcmp(argv[i], "--delta") && hasValue)
+				deltaTime = atof(argv[++i]);
+			else if(!strcmp(argv[i], "--size") && hasValue)
+			{
+				if(sscanf(argv[++i], "%ux%u", &width, &height) != 2)
+					width = height = 0;
+			}
+			else if(!strcmp(argv[i], "--output") && hasValue)
+				output = argv[++i];
+			else if(!strcmp(argv[i], "--replay") && hasValue)
+				replay = argv[++i];
+			else if(!strcmp(argv[i], "--record") && hasValue)
+				record = argv[++i];
+			else if(!strcmp(argv[i], "--simulation"))
+				simulationOnly = true;
+			else if(!strcmp(argv[i], "--update-thread"))
+				updateThread = true;
+			else if(!strcmp(argv[i], "--mobs") && hasValue)
+				mobs = atoi(argv[++i]);
+			else if(!strcmp(argv[i], "--trees") && hasValue)
+				trees = atoi(argv[++i]);
+			else if(!strcmp(argv[i], "--jobs") && hasValue)
+				jobs = atoi(argv[++i]);
+			else if(!strcmp(argv[i], "--no-cull"))
+				noCulling = true;
+			else if(!strcmp(argv[i], "--no-batch"))
+				noBatching = true;
+			else if(!strcmp(argv[i], "--no-texture-cache"))
+				noTextureCache = true;
+			else if(modeFlag(argv[i]) != BENCHMARK_GAME)
+			{
+				if(mode != BENCHMARK_GAME)
+				{
+					std::cout << "Error: " << argv[i] << " can't be combined with another benchmark mode" << std::endl;
+					return false;
+				}
+				mode = modeFlag(argv[i]);
+			}
+			else
+			{
+				std::cout << "usage: " << argv[0] << " [--frames N] [--warmup N] [--delta SECONDS] [--size WIDTHxHEIGHT] [--output FILE] [--replay FILE] [--record FILE] [--simulation] [--update-thread] [--mobs N] [--trees N] [--jobs N] [--no-cull] [--no-batch] [--no-texture-cache] [--chase | --proximity | --bvh | --dxt | --mipmap | --ycocg | --uniforms | --normals]" << std::endl;
+				return false;
+			}
+		}
+		return deltaTime > 0.0f && width > 0 && height > 0;
+	}
+
+private:
+	// the mode a flag asks for, BENCHMARK_GAME if it isn't a mode flag
+	static BenchmarkMode modeFlag(const char *flag)
+	{
+		// in the order of BenchmarkMode, after BENCHMARK_GAME
+		static const char *const flags[] = { "--chase", "--proximity", "--bvh", "--dxt", "--mipmap", "--ycocg", "--uniforms", "--normals" };
+		for(unsigned int i = 0; i < sizeof(flags) / sizeof(flags[0]); i++)
+		{
+			if(!strcmp(flag, flags[i]))
+				return (BenchmarkMode)(BENCHMARK_CHASE + i);
+		}
+		return BENCHMARK_GAME;
+	}
+};
+
+// write a report to options.output, or to standard output if that is empty: write(out) writes it and returns false if the
+// benchmark failed, and so does this if the file can't be opened
+template<typename Write>
+bool writeBenchmarkReport(const BenchmarkOptions &options, Write write)
+{
+	if(options.output.empty())
+		return write(std::cout);
+
+	std::ofstream file(options.output.c_str());
+	if(!file)
+	{
+		std::cout << "Error writing benchmark report to " << options.output << std::endl;
+		return false;
+	}
+	return write(file);
+}
+
+// the start of a report of the SIMD code's own benchmarks: every kernel header picks SSE2 on this same condition
+inline void beginKernelReport(std::ostream &out)
+{
+	out << "{\n"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		<< "\t\"kernel\": \"sse2\",\n";
+#else
+		<< "\t\"kernel\": \"scalar\",\n";
+#endif
+}
+
+// the fastest of repeats runs of run(), in milliseconds
+template<typename Run>
+double bestMilliseconds(unsigned int repeats, Run run)
+{
+	double best = 1e30;
+	for(unsigned int repeat = 0; repeat < repeats; repeat++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		run();
+		best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+	}
+	return best;
+}
+
+// a line per method of a comparison, the first one being the reference: { "label": name, "rate": items per second,
+// "speedup": against the reference... }, where milliseconds(method) times count items and fields(out, method) adds the rest
+// right after the method was timed
+template<typename Milliseconds, typename Fields>
+void writeSpeedups(std::ostream &out, const char *label, const char *rate, const char *const *names, int methods, double count,
+	Milliseconds milliseconds, Fields fields)
+{
+	double referencePerSecond = 0.0;
+	for(int method = 0; method < methods; method++)
+	{
+		double perSecond = count * 1000.0 / milliseconds(method);
+		if(method == 0)
+			referencePerSecond = perSecond;
+		out << "\t\t{ \"" << label << "\": \"" << names[method] << "\", \"" << rate << "\": " << perSecond
+			<< ", \"speedup\": " << perSecond / referencePerSecond;
+		fields(out, method);
+		out << " }" << (method + 1 < methods ? "," : "") << "\n";
+	}
+}
+
+class Benchmark
+{
+public:
+	Benchmark(const BenchmarkOptions &options) : options(options), frame(0), scriptUnit(0), frameStart(), cpuEnd(), textures(NULL) {}
+
+	// load the recording to replay if there is one, returns false if it can't be used
+	bool start()
+	{
+		if(!options.replay.empty())
+		{
+			if(!replay.load(options.replay))
+				return false;
+			if(replay.frameCount() <= options.warmupFrames)
+			{
+				std::cout << "Error: " << options.replay << " has no frames left after the warm up" << std::endl;
+				return false;
+			}
+		}
+
+		if(!options.record.empty() && !recorder.open(options.record))
+			return false;
+
+		if(options.frames == 0)
+			options.frames = replay.isOpen() ? replay.frameCount() - options.warmupFrames : 1200;
+		return true;
+	}
+
+	// add the decode and upload times of the game's textures to the report
+	void setTextureLoader(const TextureLoader *textures)
+	{
+		this->textures = textures;
+	}
+
+	// every warm up and timed frame has been run
+	bool finished() const
+	{
+		return frame >= options.warmupFrames + options.frames || (replay.isOpen() && replay.finished());
+	}
+
+	// game clock of the current frame, frames are evenly spaced (or replayed) so every run sees the same times
+	float time() const
+	{
+		if(replay.isOpen())
+			return replay.time();
+		return (frame + 1) * options.deltaTime;
+	}
+
+	void beginFrame()
+	{
+		frameStart = std::chrono::steady_clock::now();
+	}
+
+	// the keys and mouse movement of the current frame
+	void nextInput(InputState &input)
+	{
+		float frameTime = time();
+		if(replay.isOpen())
+		{
+			input = replay.read();
+			recorder.write(frameTime, input);
+			return;
+		}
+
+		input.clear();
+
+		unsigned int scriptLength = 0;
+		for(unsigned int i = 0; i < SCRIPT_STEPS; i++)
+			scriptLength = std::max(scriptLength, script()[i].first + script()[i].count);
+
+		// the script is timed in 1/60 s units of game time, so it plays out the same at any --delta:
+		// every unit that passed since the last frame adds its mouse movement and key presses,
+		// and keys of the unit the clock is in count as held
+		unsigned int unit = (unsigned int)(frameTime * SCRIPT_RATE);
+		for(unsigned int u = scriptUnit + 1; u <= unit + 1; u++)
+		{
+			// the script ends by resetting the game, so it can simply be played again
+			unsigned int scriptTime = (u - 1) % scriptLength;
+			bool passed = u <= unit;
+			for(unsigned int i = 0; i < SCRIPT_STEPS; i++)
+			{
+				const Step &step = script()[i];
+				if(scriptTime < step.first || scriptTime >= step.first + step.count)
+					continue;
+				if(step.key != INPUT_KEY_COUNT)
+					input.keys[step.key] = true;
+				if(passed)
+				{
+					input.mouseX += step.mouseX;
+					input.mouseY += step.mouseY;
+				}
+			}
+		}
+		scriptUnit = unit;
+		recorder.write(frameTime, input);
+	}
+
+	// call once everything of the frame has been submitted to OpenGL
+	void endFrame(const RenderState::Counters &counters, const RenderQueue::Stats &queueStats)
+	{
+		cpuEnd = std::chrono::steady_clock::now();
+		// wait for the GPU too, so frames can't pile up in the driver and hide their cost
+		glFinish();
+		std::chrono::steady_clock::time_point gpuEnd = std::chrono::steady_clock::now();
+
+		if(frame >= options.warmupFrames)
+		{
+			Sample sample;
+			sample.cpuMs = std::chrono::duration<double, std::milli>(cpuEnd - frameStart).count();
+			sample.frameMs = std::chrono::duration<double, std::milli>(gpuEnd - frameStart).count();
+			sample.counters = counters;
+			sample.queueStats = queueStats;
+			samples.push_back(sample);
+		}
+		frame++;
+	}
+
+	// same for a frame of the simulation benchmark, which has nothing to draw or wait for
+	void endSimulationFrame()
+	{
+		cpuEnd = std::chrono::steady_clock::now();
+		if(frame >= options.warmupFrames)
+		{
+			Sample sample;
+			sample.cpuMs = sample.frameMs = std::chrono::duration<double, std::milli>(cpuEnd - frameStart).count();
+			sample.counters.issued = sample.counters.elided = sample.counters.drawCalls = 0;
+			sample.queueStats.items = sample.queueStats.batches = sample.queueStats.culled = sample.queueStats.culledObjects = 0;
+			samples.push_back(sample);
+		}
+		frame++;
+	}
+
+	bool simulationOnly() const
+	{
+		return options.simulationOnly;
+	}
+
+	// write the JSON report, returns false if the output file can't be written
+	bool writeReport() const
+	{
+		return writeBenchmarkReport(options, [this](std::ostream &out)
+		{
+			writeReport(out);
+			return true;
+		});
+	}
+
+private:
+	// hold a key and/or move the mouse by (mouseX, mouseY) every script unit in [first, first + count)
+	struct Step
+	{
+		unsigned int first;
+		unsigned int count;
+		InputKey key;
+		float mouseX;
+		float mouseY;
+	};
+
+	struct Sample
+	{
+		double cpuMs;
+		double frameMs;
+		RenderState::Counters counters;
+		RenderQueue::Stats queueStats;
+	};
+
+	static const unsigned int SCRIPT_STEPS = 12;
+	// script units per second of game time
+	static const unsigned int SCRIPT_RATE = 60;
+
+	// a full round of the game: pick up the lamp, walk to Sven, carry him
+	// through horror mode towards the portal while the zombie chases, look around with the
+	// projection and lighting toggles, then reset
+	static const Step *script()
+	{
+		static const Step steps[SCRIPT_STEPS] = {
+			{ 5, 1, KEY_F, 0.0f, 0.0f },
+			{ 10, 240, KEY_W, 0.0f, 0.0f },
+			{ 250, 30, INPUT_KEY_COUNT, -30.0f, 0.0f },
+			{ 280, 72, KEY_W, 0.0f, 0.0f },
+			{ 355, 1, KEY_E, 0.0f, 0.0f },
+			{ 360, 60, INPUT_KEY_COUNT, 30.0f, 0.0f },
+			{ 420, 264, KEY_W, 0.0f, 0.0f },
+			{ 440, 24, KEY_D, 0.0f, 0.0f },
+			{ 700, 1, KEY_R, 0.0f, 0.0f },
+			{ 710, 1, KEY_O, 0.0f, 0.0f },
+			{ 720, 1, KEY_P, 0.0f, 0.0f },
+			{ 760, 1, KEY_R, 0.0f, 0.0f }
+		};
+		return steps;
+	}
+
+	BenchmarkOptions options;
+	InputReplay replay;
+	InputRecorder recorder;
+	unsigned int frame;
+	// script units played up to the last frame
+	unsigned int scriptUnit;
+	std::chrono::steady_clock::time_point frameStart;
+	std::chrono::steady_clock::time_point cpuEnd;
+	std::vector<Sample> samples;
+	// the textures' startup times, not owned
+	const TextureLoader *textures;
+
+	// keep a string valid inside JSON quotes
+	static std::string jsonSafe(std::string text)
+	{
+		for(size_t i = 0; i < text.size(); i++)
+		{
+			if(text[i] == '"' || text[i] == '\\')
+				text[i] = '\'';
+		}
+		return text;
+	}
+
+	// nearest rank percentile of an ascending list
+	static double percentile(const std::vector<double> &sorted, double p)
+	{
+		size_t rank = (size_t)(p / 100.0 * sorted.size() + 0.5);
+		rank = std::min(std::max(rank, (size_t)1), sorted.size());
+		return sorted[rank - 1];
+	}
+
+	static void writeTimes(std::ostream &out, const char *name, std::vector<double> times, bool last)
+	{
+		std::sort(times.begin(), times.end());
+		double sum = 0.0;
+		for(size_t i = 0; i < times.size(); i++)
+			sum += times[i];
+
+		out << "\t\"" << name << "\": { "
+			<< "\"mean\": " << sum / times.size() << ", "
+			<< "\"p50\": " << percentile(times, 50.0) << ", "
+			<< "\"p90\": " << percentile(times, 90.0) << ", "
+			<< "\"p99\": " << percentile(times, 99.0) << ", "
+			<< "\"max\": " << times.back() << " }" << (last ? "\n" : ",\n");
+	}
+
+	void writeReport(std::ostream &out) const
+	{
+		std::vector<double> cpuTimes, frameTimes;
+		double drawCalls = 0.0, issued = 0.0, elided = 0.0, cubes = 0.0, batches = 0.0, culled = 0.0, culledObjects = 0.0;
+		unsigned int maxDrawCalls = 0;
+		for(size_t i = 0; i < samples.size(); i++)
+		{
+			const Sample &sample = samples[i];
+			cpuTimes.push_back(sample.cpuMs);
+			frameTimes.push_back(sample.frameMs);
+			drawCalls += sample.counters.drawCalls;
+			issued += sample.counters.issued;
+			elided += sample.counters.elided;
+			cubes += sample.queueStats.items;
+			batches += sample.queueStats.batches;
+			culled += sample.queueStats.culled;
+			culledObjects += sample.queueStats.culledObjects;
+			maxDrawCalls = std::max(maxDrawCalls, sample.counters.drawCalls);
+		}
+		double count = samples.size();
+
+		const char *renderer = options.simulationOnly ? "none, simulation only" : (const char*)glGetString(GL_RENDERER);
+
+		out << "{\n"
+			<< "\t\"renderer\": \"" << jsonSafe(renderer ? renderer : "unknown") << "\",\n"
+			<< "\t\"input\": \"" << (replay.isOpen() ? jsonSafe(options.replay) : std::string("script")) << "\",\n"
+			<< "\t\"frames\": " << samples.size() << ",\n"
+			<< "\t\"warmupFrames\": " << options.warmupFrames << ",\n"
+			<< "\t\"deltaTime\": " << options.deltaTime << ",\n"
+			<< "\t\"mobs\": " << options.mobs << ",\n"
+			<< "\t\"trees\": " << options.trees << ",\n"
+			<< "\t\"jobs\": " << options.jobs << ",\n"
+			<< "\t\"updateThread\": " << (options.updateThread ? "true" : "false") << ",\n"
+			<< "\t\"culling\": " << (options.noCulling ? "false" : "true") << ",\n"
+			<< "\t\"staticBatch\": " << (options.noBatching ? "false" : "true") << ",\n"
+			<< "\t\"width\": " << options.width << ",\n"
+			<< "\t\"height\": " << options.height << ",\n";
+		// time spent by the CPU building and submitting a frame, then the same including the wait for the GPU
+		writeTimes(out, "cpuFrameMs", cpuTimes, false);
+		writeTimes(out, "frameMs", frameTimes, false);
+		out << "\t\"drawCallsPerFrame\": { \"mean\": " << drawCalls / count << ", \"max\": " << maxDrawCalls << " },\n"
+			<< "\t\"stateChangesPerFrame\": { \"issued\": " << issued / count << ", \"elided\": " << elided / count << " },\n"
+			<< "\t\"cubesPerFrame\": " << cubes / count << ",\n"
+			<< "\t\"batchesPerFrame\": " << batches / count << ",\n"
+			<< "\t\"culledPerFrame\": { \"cubes\": " << culled / count << ", \"creatures\": " << culledObjects / count << " }";
+		if(textures)
+		{
+			out << ",\n";
+			textures->writeJson(out);
+		}
+		out << "\n}" << std::endl;
+	}
+};
+#endif
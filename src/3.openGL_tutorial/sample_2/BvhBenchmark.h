@@ -0,0 +1,150 @@
+// TIMES THE STATIC SCENE'S BOUNDING VOLUME HIERARCHY ON SCENES OF 1 000 TO 1 000 000 CUBES: HOW LONG IT TAKES TO BUILD,
+// AND FRUSTUM AND RAY QUERIES THROUGH IT AGAINST TESTING EVERY CUBE, CHECKING THAT BOTH FIND THE SAME CUBES
+// ONLY USED BY THE HEADLESS BENCHMARK BUILD (SAMPLE_2_BENCHMARK), RUN WITH "--bvh"
+
+#ifndef BVH_BENCHMARK_H
+#define BVH_BENCHMARK_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <math.h>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Frustum.h"
+#include "StaticBvh.h"
+
+class BvhBenchmark
+{
+public:
+	BvhBenchmark(const BenchmarkOptions &options) : options(options) {}
+
+	bool run()
+	{
+		return writeBenchmarkReport(options, [this](std::ostream &out)
+		{
+			run(out);
+			return true;
+		});
+	}
+
+private:
+	void run(std::ostream &out) const
+	{
+		const unsigned int cubeCounts[] = { 1000, 10000, 100000, 1000000 };
+		const unsigned int runs = sizeof(cubeCounts) / sizeof(cubeCounts[0]);
+		const unsigned int views = 64;
+		const unsigned int rays = 1000;
+
+		out << "{\n"
+			<< "\t\"runs\": [\n";
+		for(unsigned int r = 0; r < runs; r++)
+		{
+			unsigned int cubes = cubeCounts[r];
+			// the ground grows with the cube count, so there are about as many cubes per square as in the game
+			float half = 10.0f * sqrtf(cubes / 200.0f);
+			unsigned int seed = 12345;
+			std::vector<glm::vec3> centers(cubes), extents(cubes);
+			for(unsigned int i = 0; i < cubes; i++)
+			{
+				centers[i] = glm::vec3(random(seed, -half, half), random(seed, 0.0f, 3.0f), random(seed, -half, half));
+				extents[i] = glm::vec3(random(seed, 0.05f, 0.5f), random(seed, 0.05f, 0.5f), random(seed, 0.05f, 0.5f));
+			}
+
+			StaticBvh bvh;
+			auto buildStart = std::chrono::steady_clock::now();
+			bvh.build(centers, extents);
+			double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+
+			// FRUSTUM: the game's perspective projection from eye height, looking around the middle of the ground
+			glm::mat4 projection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 100.0f);
+			std::vector<Frustum> frusta(views);
+			for(unsigned int v = 0; v < views; v++)
+			{
+				float angle = v * 6.2831853f / views;
+				glm::vec3 eye(random(seed, -half, half) * 0.5f, 0.6f, random(seed, -half, half) * 0.5f);
+				glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(sinf(angle), 0.0f, -cosf(angle)), glm::vec3(0.0f, 1.0f, 0.0f));
+				frusta[v].extract(projection * view);
+			}
+			unsigned long long bruteVisible = 0, bvhVisible = 0;
+			auto start = std::chrono::steady_clock::now();
+			for(unsigned int v = 0; v < views; v++)
+			{
+				for(unsigned int i = 0; i < cubes; i++)
+					bruteVisible += frusta[v].containsBox(centers[i], extents[i]);
+			}
+			auto middle = std::chrono::steady_clock::now();
+			for(unsigned int v = 0; v < views; v++)
+				bvh.queryFrustum(frusta[v], [&](unsigned int) { bvhVisible++; });
+			auto end = std::chrono::steady_clock::now();
+			double bruteFrustumMs = std::chrono::duration<double, std::milli>(middle - start).count() / views;
+			double bvhFrustumMs = std::chrono::duration<double, std::milli>(end - middle).count() / views;
+
+			// RAYS: from eye height in any direction, as far as the far plane
+			std::vector<glm::vec3> origins(rays), directions(rays);
+			for(unsigned int i = 0; i < rays; i++)
+			{
+				origins[i] = glm::vec3(random(seed, -half, half), 0.6f, random(seed, -half, half));
+				directions[i] = glm::normalize(glm::vec3(random(seed, -1.0f, 1.0f), random(seed, -0.3f, 0.3f), random(seed, -1.0f, 1.0f)));
+			}
+			// testing every cube gets slow, so it only does a share of the rays on the big scenes
+			unsigned int bruteRays = std::min(rays, std::max(20u, 20000000u / cubes));
+			unsigned int bruteHits = 0, bvhHits = 0, mismatches = 0;
+			std::vector<float> bruteDistances(bruteRays);
+			start = std::chrono::steady_clock::now();
+			for(unsigned int i = 0; i < bruteRays; i++)
+			{
+				glm::vec3 inverse = 1.0f / directions[i];
+				float nearest = 100.0f, enter;
+				for(unsigned int c = 0; c < cubes; c++)
+				{
+					if(StaticBvh::rayBox(origins[i], inverse, centers[c], extents[c], nearest, enter))
+						nearest = enter;
+				}
+				bruteDistances[i] = nearest;
+				bruteHits += nearest < 100.0f;
+			}
+			middle = std::chrono::steady_clock::now();
+			for(unsigned int i = 0; i < rays; i++)
+			{
+				float distance = 100.0f;
+				unsigned int cube;
+				bool hit = bvh.raycast(origins[i], directions[i], 100.0f, distance, cube);
+				if(i < bruteRays)
+				{
+					bvhHits += hit;
+					if(distance != bruteDistances[i])
+						mismatches++;
+				}
+			}
+			end = std::chrono::steady_clock::now();
+			double bruteRayMs = std::chrono::duration<double, std::milli>(middle - start).count() / bruteRays;
+			double bvhRayMs = std::chrono::duration<double, std::milli>(end - middle).count() / rays;
+
+			out << "\t\t{ \"cubes\": " << cubes
+				<< ", \"buildMs\": " << buildMs
+				<< ", \"frustum\": { \"bruteForceMs\": " << bruteFrustumMs << ", \"bvhMs\": " << bvhFrustumMs
+				<< ", \"speedup\": " << bruteFrustumMs / bvhFrustumMs << ", \"visible\": " << bruteVisible / views
+				<< ", \"sameAnswers\": " << (bruteVisible == bvhVisible ? "true" : "false") << " }"
+				<< ", \"ray\": { \"bruteForceMs\": " << bruteRayMs << ", \"bvhMs\": " << bvhRayMs
+				<< ", \"speedup\": " << bruteRayMs / bvhRayMs << ", \"rays\": " << bruteRays << ", \"hits\": " << bruteHits
+				<< ", \"sameAnswers\": " << (bruteHits == bvhHits && mismatches == 0 ? "true" : "false") << " }"
+				<< " }" << (r + 1 < runs ? "," : "") << "\n";
+		}
+		out << "\t]\n}" << std::endl;
+	}
+
+	// next number of a fixed sequence, between low and high
+	static float random(unsigned int &seed, float low, float high)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		return low + ((seed >> 8) / 16777216.0f) * (high - low);
+	}
+
+	BenchmarkOptions options;
+};
+#endif
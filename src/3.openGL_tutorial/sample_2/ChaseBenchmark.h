@@ -0,0 +1,167 @@
+// TIMES THE CHASE SYSTEM ON 1 000 TO 100 000 MOBS AGAINST ITS ONE-AT-A-TIME REFERENCE
+// AND CHECKS THAT BOTH STEER THE MOBS THE SAME WAY, WRITES MOBS PER MILLISECOND AND THE LARGEST DIFFERENCES AS JSON
+// THEN TIMES A WHOLE CREATURE TICK (CHASE, MOVE, CATCH) OF 100 000 MOBS SPREAD OVER 1, 2, 4... THREADS
+// ONLY USED BY THE HEADLESS BENCHMARK BUILD (SAMPLE_2_BENCHMARK), RUN WITH "--chase"
+
+#ifndef CHASE_BENCHMARK_H
+#define CHASE_BENCHMARK_H
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <math.h>
+#include <thread>
+
+#include "Benchmark.h"
+#include "EntityStore.h"
+#include "EntitySystems.h"
+#include "JobSystem.h"
+#include "MotionState.h"
+#include "World.h"
+
+class ChaseBenchmark
+{
+public:
+	ChaseBenchmark(const BenchmarkOptions &options) : options(options) {}
+
+	bool run()
+	{
+		return writeBenchmarkReport(options, [this](std::ostream &out)
+		{
+			run(out);
+			return true;
+		});
+	}
+
+	// mobs scattered over the map the same way every run
+	static void spawnMobs(EntityStore &store, unsigned int count)
+	{
+		unsigned int seed = 12345;
+		store.reserve(count);
+		for(unsigned int i = 0; i < count; i++)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			float x = ((seed >> 8) / 16777216.0f) * 18.0f - 9.0f;
+			seed = seed * 1664525u + 1013904223u;
+			float z = ((seed >> 8) / 16777216.0f) * 18.0f - 9.0f;
+			unsigned int mob = store.spawn(MODEL_WATER_SHEEP, glm::vec3(x, 0.35f, z), PI);
+			store.setChase(mob, 0.25f, 0.5f, 0.0f);
+		}
+	}
+
+private:
+	void run(std::ostream &out) const
+	{
+		const unsigned int mobCounts[] = { 1000, 10000, 100000 };
+		const unsigned int runs = sizeof(mobCounts) / sizeof(mobCounts[0]);
+		// the player stands inside the field of mobs, so every direction occurs
+		const glm::vec3 player(1.5f, 0.6f, -2.0f);
+
+		beginKernelReport(out);
+		out << "\t\"runs\": [\n";
+		for(unsigned int r = 0; r < runs; r++)
+		{
+			unsigned int mobs = mobCounts[r];
+			EntityStore reference, kernel;
+			spawnMobs(reference, mobs);
+			spawnMobs(kernel, mobs);
+
+			// same answer?
+			chaseReference(reference, 0, reference.size(), player);
+			chaseSystem(kernel, 0, kernel.size(), player, true);
+			float headingError = 0.0f, velocityError = 0.0f;
+			for(unsigned int i = 0; i < mobs; i++)
+			{
+				headingError = std::max(headingError, fabsf(blendAngle(reference.heading[i], kernel.heading[i], 1.0f) - reference.heading[i]));
+				velocityError = std::max(velocityError, fabsf(reference.velocityX[i] - kernel.velocityX[i]));
+				velocityError = std::max(velocityError, fabsf(reference.velocityZ[i] - kernel.velocityZ[i]));
+			}
+
+			// about ten million mob updates per measurement, the best of five
+			unsigned int iterations = std::max(10u, 10000000u / mobs);
+			double referenceMs = 1e30, kernelMs = 1e30;
+			for(unsigned int repeat = 0; repeat < 5; repeat++)
+			{
+				auto start = std::chrono::steady_clock::now();
+				for(unsigned int n = 0; n < iterations; n++)
+					chaseReference(reference, 0, reference.size(), player);
+				auto middle = std::chrono::steady_clock::now();
+				for(unsigned int n = 0; n < iterations; n++)
+					chaseSystem(kernel, 0, kernel.size(), player, true);
+				auto end = std::chrono::steady_clock::now();
+				referenceMs = std::min(referenceMs, std::chrono::duration<double, std::milli>(middle - start).count());
+				kernelMs = std::min(kernelMs, std::chrono::duration<double, std::milli>(end - middle).count());
+			}
+
+			double updates = (double)mobs * iterations;
+			out << "\t\t{ \"mobs\": " << mobs
+				<< ", \"referenceMobsPerMs\": " << updates / referenceMs
+				<< ", \"kernelMobsPerMs\": " << updates / kernelMs
+				<< ", \"speedup\": " << referenceMs / kernelMs
+				<< ", \"maxHeadingError\": " << headingError
+				<< ", \"maxVelocityError\": " << velocityError
+				<< " }" << (r + 1 < runs ? "," : "") << "\n";
+		}
+		out << "\t],\n";
+		writeScaling(out, player);
+		out << "}" << std::endl;
+	}
+
+	// ONE CREATURE TICK OVER A JOB SYSTEM OF 1, 2, 4... THREADS, AT LEAST UP TO 4 AND TO THE CORES OF THIS MACHINE
+	// (on fewer cores than threads the extra ones only show the cost of the job system)
+	void writeScaling(std::ostream &out, const glm::vec3 &player) const
+	{
+		const unsigned int mobs = 100000;
+		const unsigned int ticks = 200;
+		const float dt = 1.0f / 60.0f;
+		unsigned int cores = std::thread::hardware_concurrency();
+		unsigned int maxThreads = std::max(4u, cores);
+
+		out << "\t\"cores\": " << cores << ",\n"
+			<< "\t\"scaling\": [\n";
+		double oneThreadMs = 0.0;
+		for(unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+		{
+			JobSystem jobs(threads - 1);
+			double tickMs = 1e30;
+			for(unsigned int repeat = 0; repeat < 5; repeat++)
+			{
+				// the same mobs from the same place every time, so every thread count does the same work
+				EntityStore entities;
+				spawnMobs(entities, mobs);
+				std::atomic<bool> caught(false);
+				auto start = std::chrono::steady_clock::now();
+				for(unsigned int n = 0; n < ticks; n++)
+				{
+					jobs.parallelFor(0, entities.size(), World::MOBS_PER_JOB, [&](size_t first, size_t last)
+					{
+						chaseSystem(entities, first, last, player, true);
+						moveSystem(entities, first, last, dt);
+					});
+					jobs.parallelFor(0, entities.size(), World::MOBS_PER_JOB, [&](size_t first, size_t last)
+					{
+						if(catchSystem(entities, first, last, player))
+							caught = true;
+					});
+				}
+				auto end = std::chrono::steady_clock::now();
+				tickMs = std::min(tickMs, std::chrono::duration<double, std::milli>(end - start).count() / ticks);
+			}
+			if(threads == 1)
+				oneThreadMs = tickMs;
+
+			out << "\t\t{ \"threads\": " << threads
+				<< ", \"mobs\": " << mobs
+				<< ", \"tickMs\": " << tickMs
+				<< ", \"speedup\": " << oneThreadMs / tickMs
+				<< " }" << (threads * 2 <= maxThreads ? "," : "") << "\n";
+		}
+		out << "\t]\n";
+	}
+
+	BenchmarkOptions options;
+};
+#endif
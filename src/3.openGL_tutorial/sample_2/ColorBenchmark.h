@@ -0,0 +1,259 @@
+// TIMES THE COLOR CONVERSIONS (SEE ColorConversion.h) WITH SSE2 AND, WHEN THE PROCESSOR HAS IT, AVX2 AGAINST THEIR REFERENCES IN
+// includes/image_helper.c ON A 2048x2048 IMAGE, AFTER CHECKING THAT EACH CONVERTS EVERY RGB COLOR (AND EVERY YCoCg ONE BACK)
+// AND IMAGES OF AWKWARD SIZES THE SAME WAY AS THE REFERENCE,
+// THEN COMPRESSES THE GAME'S RGB TEXTURES TO DXT5 IN YCoCg BOTH WAYS, WITH THE ERROR AGAINST THE SOURCE NEXT TO PLAIN DXT1'S
+// WRITES MEGABYTES OF PIXELS PER SECOND AS JSON
+// ONLY USED BY THE HEADLESS BENCHMARK BUILD (SAMPLE_2_BENCHMARK), RUN WITH "--ycocg"
+
+#ifndef COLOR_BENCHMARK_H
+#define COLOR_BENCHMARK_H
+
+#include <image_DXT.h>
+#include <image_helper.h>
+#include <learnopengl/filesystem.h>
+#include <stb_image.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include "Benchmark.h"
+#include "ColorConversion.h"
+#include "DxtBenchmark.h"
+#include "DxtCompressor.h"
+
+class ColorBenchmark
+{
+public:
+	ColorBenchmark(const BenchmarkOptions &options) : options(options) {}
+
+	bool run()
+	{
+		return writeBenchmarkReport(options, [this](std::ostream &out)
+		{
+			return run(out);
+		});
+	}
+
+private:
+	// the conversions as function pointers, so the reference and the SSE2 and AVX2 versions can be timed the same way
+	typedef int (*ReferenceConversion)(unsigned char *, int, int, int);
+	typedef bool (*Conversion)(unsigned char *, int, int, int, bool);
+
+	struct Kernel
+	{
+		const char *name;
+		ReferenceConversion reference;
+		Conversion converted;
+		int minChannels;
+		int maxChannels;
+	};
+
+	bool run(std::ostream &out) const
+	{
+		const Kernel kernels[] = { { "rgbToYCoCg", convert_RGB_to_YCoCg, convertRgbToYCoCg, 3, 4 },
+			{ "yCoCgToRgb", convert_YCoCg_to_RGB, convertYCoCgToRgb, 3, 4 },
+			{ "ntscSafe", scale_image_RGB_to_NTSC_safe, scaleRgbToNtscSafe, 1, 4 } };
+		const unsigned int kernelCount = sizeof(kernels) / sizeof(kernels[0]);
+		const int width = 2048, height = 2048;
+		const unsigned int repeats = 10;
+		bool avx2 = hasAvx2();
+
+		beginKernelReport(out);
+		out << "\t\"avx2\": " << (avx2 ? "true" : "false") << ",\n"
+			<< "\t\"conversions\": [\n";
+		bool allIdentical = true;
+		for(unsigned int k = 0; k < kernelCount; k++)
+		{
+			for(int channels = kernels[k].minChannels; channels <= kernels[k].maxChannels; channels++)
+			{
+				bool identical = sameConversion(kernels[k], channels, false) && (!avx2 || sameConversion(kernels[k], channels, true));
+				std::vector<unsigned char> source = noise((size_t)width * height * channels), reference, converted, wide;
+				double referenceMs = 1e30, convertedMs = 1e30, avx2Ms = 1e30;
+				for(unsigned int repeat = 0; repeat < repeats; repeat++)
+				{
+					reference = source;
+					converted = source;
+					wide = source;
+					auto start = std::chrono::steady_clock::now();
+					kernels[k].reference(&reference[0], width, height, channels);
+					auto referenceEnd = std::chrono::steady_clock::now();
+					kernels[k].converted(&converted[0], width, height, channels, false);
+					auto convertedEnd = std::chrono::steady_clock::now();
+					if(avx2)
+						kernels[k].converted(&wide[0], width, height, channels, true);
+					auto avx2End = std::chrono::steady_clock::now();
+
+					referenceMs = std::min(referenceMs, std::chrono::duration<double, std::milli>(referenceEnd - start).count());
+					convertedMs = std::min(convertedMs, std::chrono::duration<double, std::milli>(convertedEnd - referenceEnd).count());
+					avx2Ms = std::min(avx2Ms, std::chrono::duration<double, std::milli>(avx2End - convertedEnd).count());
+				}
+				identical = identical && reference == converted && (!avx2 || reference == wide);
+				allIdentical = allIdentical && identical;
+
+				double megabytes = (double)source.size() / (1024.0 * 1024.0);
+				out << "\t\t{ \"conversion\": \"" << kernels[k].name << "\", \"channels\": " << channels
+					<< ", \"referenceMBps\": " << megabytes * 1000.0 / referenceMs << ", \"sse2MBps\": " << megabytes * 1000.0 / convertedMs;
+				if(avx2)
+					out << ", \"avx2MBps\": " << megabytes * 1000.0 / avx2Ms;
+				out << ", \"speedup\": " << referenceMs / convertedMs;
+				if(avx2)
+					out << ", \"avx2Speedup\": " << referenceMs / avx2Ms;
+				out << ", \"identical\": " << (identical ? "true" : "false") << " }"
+					<< (k + 1 < kernelCount || channels < kernels[k].maxChannels ? "," : "") << "\n";
+			}
+		}
+		out << "\t],\n";
+
+		if(!compressTextures(out, allIdentical))
+			return false;
+		out << "\t\"identical\": " << (allIdentical ? "true" : "false") << "\n"
+			<< "}" << std::endl;
+		return true;
+	}
+
+	// the game's RGB textures through the DXT5 YCoCg path: the reference's conversion and compressor against compressDxtYCoCg()
+	bool compressTextures(std::ostream &out, bool &allIdentical) const
+	{
+		const char *files[] = { "handle.jpg", "sky.jpg", "dirt.jpg", "svenBody.jpg", "svenHead.png", "waterSheepBody.jpg", "sheepHead.jpg",
+			"waterSheepFace.png", "wood.jpg", "zombieBody.jpg", "zombieHead.jpg", "denim.jpeg", "podzol.jpg", "gamewin.jpg", "glowstone.jpeg",
+			"portal.jpeg" };
+		const unsigned int fileCount = sizeof(files) / sizeof(files[0]);
+
+		out << "\t\"dxt5YCoCg\": [\n";
+		for(unsigned int f = 0; f < fileCount; f++)
+		{
+			std::string path = FileSystem::getPath(std::string("resources/textures/") + files[f]);
+			int width, height, channels;
+			unsigned char *pixels = stbi_load(path.c_str(), &width, &height, &channels, 3);
+			if(!pixels)
+			{
+				std::cout << "Error loading " << path << std::endl;
+				return false;
+			}
+			size_t count = (size_t)width * height;
+			std::vector<unsigned char> blocks(dxtSize(width, height, true)), plain(dxtSize(width, height, false));
+
+			// the reference: convert in place, then compress
+			auto start = std::chrono::steady_clock::now();
+			std::vector<unsigned char> rgba(count * 4);
+			for(size_t i = 0; i < count; i++)
+			{
+				memcpy(&rgba[i * 4], pixels + i * 3, 3);
+				rgba[i * 4 + 3] = 255;
+			}
+			convert_RGB_to_YCoCg(&rgba[0], width, height, 4);
+			int size = 0;
+			unsigned char *reference = convert_image_to_DXT5(&rgba[0], width, height, 4, &size);
+			auto referenceEnd = std::chrono::steady_clock::now();
+			compressDxtYCoCg(pixels, width, height, 3, &blocks[0]);
+			auto compressedEnd = std::chrono::steady_clock::now();
+			compressDxt(pixels, width, height, 3, false, &plain[0]);
+
+			bool identical = (size_t)size == blocks.size() && memcmp(reference, &blocks[0], size) == 0;
+			free(reference);
+			allIdentical = allIdentical && identical;
+			double yCoCgError = rootMeanSquareError(pixels, width, height, blocks, true);
+			double dxt1Error = rootMeanSquareError(pixels, width, height, plain, false);
+			stbi_image_free(pixels);
+
+			double megabytes = (double)count * 3 / (1024.0 * 1024.0);
+			double referenceMs = std::chrono::duration<double, std::milli>(referenceEnd - start).count();
+			double compressedMs = std::chrono::duration<double, std::milli>(compressedEnd - referenceEnd).count();
+			out << "\t\t{ \"file\": \"" << files[f] << "\", \"referenceMBps\": " << megabytes * 1000.0 / referenceMs
+				<< ", \"compressedMBps\": " << megabytes * 1000.0 / compressedMs << ", \"dxt5YCoCgRmse\": " << yCoCgError << ", \"dxt1Rmse\": " << dxt1Error
+				<< ", \"identical\": " << (identical ? "true" : "false") << " }" << (f + 1 < fileCount ? "," : "") << "\n";
+		}
+		out << "\t],\n";
+		return true;
+	}
+
+	// can the AVX2 conversions run here?
+	static bool hasAvx2()
+	{
+#ifdef COLOR_CONVERSION_AVX2
+		return cpuHasAvx2();
+#else
+		return false;
+#endif
+	}
+
+	// the same result on every RGB color (and every YCoCg one back), then on noise of a few sizes so the references convert the ends
+	static bool sameConversion(const Kernel &kernel, int channels, bool avx2)
+	{
+		// every combination of the first three bytes, the fourth counting along
+		std::vector<unsigned char> every((size_t)(1 << 24) * channels);
+		for(size_t i = 0; i < (1 << 24); i++)
+		{
+			for(int c = 0; c < channels; c++)
+				every[i * channels + c] = c < 3 ? (unsigned char)(i >> (8 * c)) : (unsigned char)i;
+		}
+		if(!same(kernel, every, 4096, 4096, channels, avx2))
+			return false;
+
+		const int sizes[][2] = { { 1, 1 }, { 15, 1 }, { 16, 1 }, { 17, 1 }, { 31, 1 }, { 32, 1 }, { 33, 3 }, { 49, 1 }, { 554, 554 }, { 1, 300 } };
+		for(unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+		{
+			if(!same(kernel, noise((size_t)sizes[s][0] * sizes[s][1] * channels), sizes[s][0], sizes[s][1], channels, avx2))
+				return false;
+		}
+		return true;
+	}
+
+	static bool same(const Kernel &kernel, const std::vector<unsigned char> &source, int width, int height, int channels, bool avx2)
+	{
+		std::vector<unsigned char> reference = source, converted = source;
+		kernel.reference(&reference[0], width, height, channels);
+		kernel.converted(&converted[0], width, height, channels, avx2);
+		return reference == converted;
+	}
+
+	static std::vector<unsigned char> noise(size_t bytes)
+	{
+		std::vector<unsigned char> pixels(bytes);
+		unsigned int seed = 12345;
+		for(size_t i = 0; i < bytes; i++)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			pixels[i] = (unsigned char)(seed >> 24);
+		}
+		return pixels;
+	}
+
+	// error of the decompressed blocks against the RGB source over red, green and blue, converted back from YCoCg first if yCoCg
+	static double rootMeanSquareError(const unsigned char *pixels, int width, int height, const std::vector<unsigned char> &blocks, bool yCoCg)
+	{
+		double sum = 0.0;
+		const unsigned char *block = &blocks[0];
+		for(int y = 0; y < height; y += 4)
+		{
+			for(int x = 0; x < width; x += 4)
+			{
+				unsigned char decoded[16][4];
+				DxtBenchmark::decodeBlock(block, yCoCg, decoded);
+				block += yCoCg ? 16 : 8;
+				if(yCoCg)
+					convert_YCoCg_to_RGB(&decoded[0][0], 16, 1, 4);
+				for(int j = 0; j < 4 && y + j < height; j++)
+				{
+					for(int i = 0; i < 4 && x + i < width; i++)
+					{
+						const unsigned char *pixel = pixels + ((size_t)(y + j) * width + x + i) * 3;
+						for(int c = 0; c < 3; c++)
+						{
+							double difference = pixel[c] - decoded[j * 4 + i][c];
+							sum += difference * difference;
+						}
+					}
+				}
+			}
+		}
+		return sqrt(sum / ((double)width * height * 3));
+	}
+
+	BenchmarkOptions options;
+};
+#endif
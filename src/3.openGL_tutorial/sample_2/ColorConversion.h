@@ -0,0 +1,430 @@
+// COLOR CONVERSIONS OF WHOLE IMAGES IN PLACE, BYTE FOR BYTE THE SAME AS convert_RGB_to_YCoCg, convert_YCoCg_to_RGB AND
+// scale_image_RGB_to_NTSC_safe IN includes/image_helper.c (THE REFERENCES THEY ARE CHECKED AGAINST, SEE ColorBenchmark.h),
+// BUT SIXTEEN PIXELS AT A TIME WITH SSE2, OR 32 WITH AVX2 ON PROCESSORS THAT HAVE IT (SEE CpuFeatures.h): THE PIXELS ARE
+// SPLIT INTO ONE REGISTER PER CHANNEL, CONVERTED IN 16 BITS AND INTERLEAVED AGAIN, THE PIXELS LEFT OVER (OR ALL OF THEM
+// WITHOUT SSE2) GO THROUGH THE REFERENCES
+
+#ifndef COLOR_CONVERSION_H
+#define COLOR_CONVERSION_H
+
+#include <image_helper.h>
+
+#include <string.h>
+
+#include "CpuFeatures.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COLOR_CONVERSION_SSE2
+#include <emmintrin.h>
+#ifdef CPU_FEATURES_AVX2
+#define COLOR_CONVERSION_AVX2
+#endif
+#endif
+
+#ifdef COLOR_CONVERSION_SSE2
+// 16 pixels of 4 bytes (x0 holds the first four) to a register per byte of a pixel, in the same pixel order
+inline void colorSplit(__m128i &x0, __m128i &x1, __m128i &x2, __m128i &x3)
+{
+	// pixels 0 and 8, 1 and 9... side by side, then 0, 4, 8 and 12..., then channels 0 and 1 of pixels 0, 1, 4, 5, 8, 9, 12 and 13...
+	__m128i a = _mm_unpacklo_epi8(x0, x2), b = _mm_unpackhi_epi8(x0, x2);
+	__m128i c = _mm_unpacklo_epi8(x1, x3), d = _mm_unpackhi_epi8(x1, x3);
+	__m128i e = _mm_unpacklo_epi8(a, c), f = _mm_unpackhi_epi8(a, c);
+	__m128i g = _mm_unpacklo_epi8(b, d), h = _mm_unpackhi_epi8(b, d);
+	__m128i i = _mm_unpacklo_epi8(e, f), j = _mm_unpackhi_epi8(e, f);
+	__m128i k = _mm_unpacklo_epi8(g, h), l = _mm_unpackhi_epi8(g, h);
+	x0 = _mm_unpacklo_epi16(i, k);
+	x1 = _mm_unpackhi_epi16(i, k);
+	x2 = _mm_unpacklo_epi16(j, l);
+	x3 = _mm_unpackhi_epi16(j, l);
+}
+
+// the other way around
+inline void colorJoin(__m128i &x0, __m128i &x1, __m128i &x2, __m128i &x3)
+{
+	__m128i a = _mm_unpacklo_epi8(x0, x1), b = _mm_unpackhi_epi8(x0, x1);
+	__m128i c = _mm_unpacklo_epi8(x2, x3), d = _mm_unpackhi_epi8(x2, x3);
+	x0 = _mm_unpacklo_epi16(a, c);
+	x1 = _mm_unpackhi_epi16(a, c);
+	x2 = _mm_unpacklo_epi16(b, d);
+	x3 = _mm_unpackhi_epi16(b, d);
+}
+
+// the 12 bytes of 4 RGB pixels at the bottom of packed to a pixel per 32 bit lane, the top byte of every lane 0
+inline __m128i colorSpreadRgb(__m128i packed)
+{
+	const __m128i pixel = _mm_setr_epi32(0xFFFFFF, 0, 0, 0);
+	return _mm_or_si128(_mm_or_si128(_mm_and_si128(packed, pixel), _mm_and_si128(_mm_slli_si128(packed, 1), _mm_slli_si128(pixel, 4))),
+		_mm_or_si128(_mm_and_si128(_mm_slli_si128(packed, 2), _mm_slli_si128(pixel, 8)), _mm_and_si128(_mm_slli_si128(packed, 3), _mm_slli_si128(pixel, 12))));
+}
+
+// the other way around, the top 4 bytes of the result are 0
+inline __m128i colorPackRgb(__m128i spread)
+{
+	const __m128i pixel = _mm_setr_epi32(0xFFFFFF, 0, 0, 0);
+	return _mm_or_si128(_mm_or_si128(_mm_and_si128(spread, pixel), _mm_srli_si128(_mm_and_si128(spread, _mm_slli_si128(pixel, 4)), 1)),
+		_mm_or_si128(_mm_srli_si128(_mm_and_si128(spread, _mm_slli_si128(pixel, 8)), 2), _mm_srli_si128(_mm_and_si128(spread, _mm_slli_si128(pixel, 12)), 3)));
+}
+
+// 16 pixels from pixels, 4 bytes each: as they are for RGBA, and with a fourth byte of 0 for RGB
+inline void colorLoad(const unsigned char *pixels, int channels, __m128i &x0, __m128i &x1, __m128i &x2, __m128i &x3)
+{
+	__m128i a = _mm_loadu_si128((const __m128i *)pixels);
+	__m128i b = _mm_loadu_si128((const __m128i *)(pixels + 16));
+	__m128i c = _mm_loadu_si128((const __m128i *)(pixels + 32));
+	if(channels == 4)
+	{
+		x0 = a;
+		x1 = b;
+		x2 = c;
+		x3 = _mm_loadu_si128((const __m128i *)(pixels + 48));
+		return;
+	}
+	// 48 bytes, 12 per 4 pixels
+	x0 = colorSpreadRgb(a);
+	x1 = colorSpreadRgb(_mm_or_si128(_mm_srli_si128(a, 12), _mm_slli_si128(b, 4)));
+	x2 = colorSpreadRgb(_mm_or_si128(_mm_srli_si128(b, 8), _mm_slli_si128(c, 8)));
+	x3 = colorSpreadRgb(_mm_srli_si128(c, 4));
+}
+
+// the same the other way around, the fourth byte of an RGB pixel is dropped
+inline void colorStore(unsigned char *pixels, int channels, __m128i x0, __m128i x1, __m128i x2, __m128i x3)
+{
+	if(channels == 4)
+	{
+		_mm_storeu_si128((__m128i *)pixels, x0);
+		_mm_storeu_si128((__m128i *)(pixels + 16), x1);
+		_mm_storeu_si128((__m128i *)(pixels + 32), x2);
+		_mm_storeu_si128((__m128i *)(pixels + 48), x3);
+		return;
+	}
+	x0 = colorPackRgb(x0);
+	x1 = colorPackRgb(x1);
+	x2 = colorPackRgb(x2);
+	x3 = colorPackRgb(x3);
+	_mm_storeu_si128((__m128i *)pixels, _mm_or_si128(x0, _mm_slli_si128(x1, 12)));
+	_mm_storeu_si128((__m128i *)(pixels + 16), _mm_or_si128(_mm_srli_si128(x1, 4), _mm_slli_si128(x2, 8)));
+	_mm_storeu_si128((__m128i *)(pixels + 32), _mm_or_si128(_mm_srli_si128(x2, 8), _mm_slli_si128(x3, 4)));
+}
+
+// the low (half 0) or high (half 1) 8 bytes of a channel register as 16 bit lanes
+inline __m128i colorWiden(__m128i channel, int half)
+{
+	return half == 0 ? _mm_unpacklo_epi8(channel, _mm_setzero_si128()) : _mm_unpackhi_epi8(channel, _mm_setzero_si128());
+}
+
+#ifdef COLOR_CONVERSION_AVX2
+// the AVX2 versions work on two blocks of 16 pixels at once, one in each half of the registers: the unpacks, packs and byte
+// shifts all stay within a half, so each half goes through the same steps as the SSE2 versions
+
+// colorSplit() and colorJoin() on both halves
+CPU_FEATURES_AVX2_TARGET inline void colorSplitAvx2(__m256i &x0, __m256i &x1, __m256i &x2, __m256i &x3)
+{
+	__m256i a = _mm256_unpacklo_epi8(x0, x2), b = _mm256_unpackhi_epi8(x0, x2);
+	__m256i c = _mm256_unpacklo_epi8(x1, x3), d = _mm256_unpackhi_epi8(x1, x3);
+	__m256i e = _mm256_unpacklo_epi8(a, c), f = _mm256_unpackhi_epi8(a, c);
+	__m256i g = _mm256_unpacklo_epi8(b, d), h = _mm256_unpackhi_epi8(b, d);
+	__m256i i = _mm256_unpacklo_epi8(e, f), j = _mm256_unpackhi_epi8(e, f);
+	__m256i k = _mm256_unpacklo_epi8(g, h), l = _mm256_unpackhi_epi8(g, h);
+	x0 = _mm256_unpacklo_epi16(i, k);
+	x1 = _mm256_unpackhi_epi16(i, k);
+	x2 = _mm256_unpacklo_epi16(j, l);
+	x3 = _mm256_unpackhi_epi16(j, l);
+}
+
+CPU_FEATURES_AVX2_TARGET inline void colorJoinAvx2(__m256i &x0, __m256i &x1, __m256i &x2, __m256i &x3)
+{
+	__m256i a = _mm256_unpacklo_epi8(x0, x1), b = _mm256_unpackhi_epi8(x0, x1);
+	__m256i c = _mm256_unpacklo_epi8(x2, x3), d = _mm256_unpackhi_epi8(x2, x3);
+	x0 = _mm256_unpacklo_epi16(a, c);
+	x1 = _mm256_unpackhi_epi16(a, c);
+	x2 = _mm256_unpacklo_epi16(b, d);
+	x3 = _mm256_unpackhi_epi16(b, d);
+}
+
+// 16 bytes from low and 16 from high in one register, and back
+CPU_FEATURES_AVX2_TARGET inline __m256i colorLoadHalves(const unsigned char *low, const unsigned char *high)
+{
+	return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)low)), _mm_loadu_si128((const __m128i *)high), 1);
+}
+
+CPU_FEATURES_AVX2_TARGET inline void colorStoreHalves(unsigned char *low, unsigned char *high, __m256i x)
+{
+	_mm_storeu_si128((__m128i *)low, _mm256_castsi256_si128(x));
+	_mm_storeu_si128((__m128i *)high, _mm256_extracti128_si256(x, 1));
+}
+
+// 32 pixels from pixels, 4 bytes each: RGBA pixels as they come (every half still gets 16 pixels, which pixels does not
+// matter as long as colorStoreAvx2() puts them back), RGB pixels 48 bytes to a half with a fourth byte of 0
+CPU_FEATURES_AVX2_TARGET inline void colorLoadAvx2(const unsigned char *pixels, int channels, __m256i &x0, __m256i &x1, __m256i &x2, __m256i &x3)
+{
+	if(channels == 4)
+	{
+		x0 = _mm256_loadu_si256((const __m256i *)pixels);
+		x1 = _mm256_loadu_si256((const __m256i *)(pixels + 32));
+		x2 = _mm256_loadu_si256((const __m256i *)(pixels + 64));
+		x3 = _mm256_loadu_si256((const __m256i *)(pixels + 96));
+		return;
+	}
+	// colorSpreadRgb() is a single shuffle with AVX2
+	const __m256i spread = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+		0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	__m256i a = colorLoadHalves(pixels, pixels + 48);
+	__m256i b = colorLoadHalves(pixels + 16, pixels + 64);
+	__m256i c = colorLoadHalves(pixels + 32, pixels + 80);
+	x0 = _mm256_shuffle_epi8(a, spread);
+	x1 = _mm256_shuffle_epi8(_mm256_alignr_epi8(b, a, 12), spread);
+	x2 = _mm256_shuffle_epi8(_mm256_alignr_epi8(c, b, 8), spread);
+	x3 = _mm256_shuffle_epi8(_mm256_srli_si256(c, 4), spread);
+}
+
+// the same the other way around, the fourth byte of an RGB pixel is dropped
+CPU_FEATURES_AVX2_TARGET inline void colorStoreAvx2(unsigned char *pixels, int channels, __m256i x0, __m256i x1, __m256i x2, __m256i x3)
+{
+	if(channels == 4)
+	{
+		_mm256_storeu_si256((__m256i *)pixels, x0);
+		_mm256_storeu_si256((__m256i *)(pixels + 32), x1);
+		_mm256_storeu_si256((__m256i *)(pixels + 64), x2);
+		_mm256_storeu_si256((__m256i *)(pixels + 96), x3);
+		return;
+	}
+	const __m256i pack = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+		0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+	x0 = _mm256_shuffle_epi8(x0, pack);
+	x1 = _mm256_shuffle_epi8(x1, pack);
+	x2 = _mm256_shuffle_epi8(x2, pack);
+	x3 = _mm256_shuffle_epi8(x3, pack);
+	colorStoreHalves(pixels, pixels + 48, _mm256_or_si256(x0, _mm256_slli_si256(x1, 12)));
+	colorStoreHalves(pixels + 16, pixels + 64, _mm256_or_si256(_mm256_srli_si256(x1, 4), _mm256_slli_si256(x2, 8)));
+	colorStoreHalves(pixels + 32, pixels + 80, _mm256_or_si256(_mm256_srli_si256(x2, 8), _mm256_slli_si256(x3, 4)));
+}
+
+// colorWiden() on both halves
+CPU_FEATURES_AVX2_TARGET inline __m256i colorWidenAvx2(__m256i channel, int half)
+{
+	return half == 0 ? _mm256_unpacklo_epi8(channel, _mm256_setzero_si256()) : _mm256_unpackhi_epi8(channel, _mm256_setzero_si256());
+}
+
+// convertRgbToYCoCg() 32 pixels at a time, returns how many pixels it converted
+CPU_FEATURES_AVX2_TARGET inline size_t convertRgbToYCoCgAvx2(unsigned char *pixels, size_t count, int channels)
+{
+	const __m256i one = _mm256_set1_epi16(1), two = _mm256_set1_epi16(2), half = _mm256_set1_epi16(128);
+	size_t i = 0;
+	for(; i + 32 <= count; i += 32)
+	{
+		unsigned char *block = pixels + i * channels;
+		__m256i r, g, b, a;
+		colorLoadAvx2(block, channels, r, g, b, a);
+		colorSplitAvx2(r, g, b, a);
+		__m256i co[2], y[2], cg[2];
+		for(int h = 0; h < 2; h++)
+		{
+			__m256i red = colorWidenAvx2(r, h), blue = colorWidenAvx2(b, h);
+			__m256i green = _mm256_srli_epi16(_mm256_add_epi16(colorWidenAvx2(g, h), one), 1);
+			__m256i tmp = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(red, blue), two), 2);
+			co[h] = _mm256_add_epi16(half, _mm256_srai_epi16(_mm256_add_epi16(_mm256_sub_epi16(red, blue), one), 1));
+			y[h] = _mm256_add_epi16(green, tmp);
+			cg[h] = _mm256_sub_epi16(_mm256_add_epi16(half, green), tmp);
+		}
+		__m256i coBytes = _mm256_packus_epi16(co[0], co[1]), yBytes = _mm256_packus_epi16(y[0], y[1]), cgBytes = _mm256_packus_epi16(cg[0], cg[1]);
+		if(channels == 3)
+		{
+			colorJoinAvx2(coBytes, yBytes, cgBytes, a);
+			colorStoreAvx2(block, channels, coBytes, yBytes, cgBytes, a);
+		}
+		else
+		{
+			colorJoinAvx2(coBytes, cgBytes, a, yBytes);
+			colorStoreAvx2(block, channels, coBytes, cgBytes, a, yBytes);
+		}
+	}
+	return i;
+}
+
+// convertYCoCgToRgb() 32 pixels at a time, returns how many pixels it converted
+CPU_FEATURES_AVX2_TARGET inline size_t convertYCoCgToRgbAvx2(unsigned char *pixels, size_t count, int channels)
+{
+	const __m256i half = _mm256_set1_epi16(128);
+	size_t i = 0;
+	for(; i + 32 <= count; i += 32)
+	{
+		unsigned char *block = pixels + i * channels;
+		__m256i x0, x1, x2, x3;
+		colorLoadAvx2(block, channels, x0, x1, x2, x3);
+		colorSplitAvx2(x0, x1, x2, x3);
+		__m256i coBytes = x0, yBytes = channels == 3 ? x1 : x3, cgBytes = channels == 3 ? x2 : x1, rest = channels == 3 ? x3 : x2;
+		__m256i r[2], g[2], b[2];
+		for(int h = 0; h < 2; h++)
+		{
+			__m256i co = _mm256_sub_epi16(colorWidenAvx2(coBytes, h), half), cg = _mm256_sub_epi16(colorWidenAvx2(cgBytes, h), half);
+			__m256i y = colorWidenAvx2(yBytes, h);
+			r[h] = _mm256_sub_epi16(_mm256_add_epi16(y, co), cg);
+			g[h] = _mm256_add_epi16(y, cg);
+			b[h] = _mm256_sub_epi16(_mm256_sub_epi16(y, co), cg);
+		}
+		__m256i red = _mm256_packus_epi16(r[0], r[1]), green = _mm256_packus_epi16(g[0], g[1]), blue = _mm256_packus_epi16(b[0], b[1]);
+		colorJoinAvx2(red, green, blue, rest);
+		colorStoreAvx2(block, channels, red, green, blue, rest);
+	}
+	return i;
+}
+
+// scaleRgbToNtscSafe() 32 bytes at a time for 1 to 4 channels, returns how many bytes it scaled
+CPU_FEATURES_AVX2_TARGET inline size_t scaleRgbToNtscSafeAvx2(unsigned char *pixels, size_t bytes, int channels)
+{
+	const __m256i factors = _mm256_setr_epi16(28268, 31763, 28268, 31763, 28268, 31763, 28268, 31763,
+		28268, 31763, 28268, 31763, 28268, 31763, 28268, 31763);
+	const __m256i sixteen = _mm256_set1_epi16(16);
+	const __m256i alpha = channels == 2 ? _mm256_set1_epi16((short)0xFF00)
+		: (channels == 4 ? _mm256_set1_epi32((int)0xFF000000) : _mm256_setzero_si256());
+	size_t i = 0;
+	for(; i + 32 <= bytes; i += 32)
+	{
+		__m256i source = _mm256_loadu_si256((const __m256i *)(pixels + i));
+		__m256i words[2];
+		for(int h = 0; h < 2; h++)
+		{
+			__m256i c = colorWidenAvx2(source, h);
+			__m256i low = _mm256_srai_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(c, sixteen), factors), 15);
+			__m256i high = _mm256_srai_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(c, sixteen), factors), 15);
+			words[h] = _mm256_packs_epi32(low, high);
+		}
+		__m256i scaled = _mm256_packus_epi16(words[0], words[1]);
+		_mm256_storeu_si256((__m256i *)(pixels + i), _mm256_or_si256(_mm256_andnot_si256(alpha, scaled), _mm256_and_si256(alpha, source)));
+	}
+	return i;
+}
+#endif
+#endif
+
+// RGB to YCoCg in the reference's order: Co, Y, Cg for 3 channels and Co, Cg, alpha, Y for 4, false for other channel counts;
+// AVX2 is used when the processor has it unless avx2 is false (the benchmark timing SSE2 alone)
+inline bool convertRgbToYCoCg(unsigned char *pixels, int width, int height, int channels, bool avx2 = true)
+{
+	if(!pixels || width < 1 || height < 1 || channels < 3 || channels > 4)
+		return false;
+	size_t count = (size_t)width * height, i = 0;
+#ifdef COLOR_CONVERSION_AVX2
+	if(avx2 && cpuHasAvx2())
+		i = convertRgbToYCoCgAvx2(pixels, count, channels);
+#endif
+#ifdef COLOR_CONVERSION_SSE2
+	const __m128i one = _mm_set1_epi16(1), two = _mm_set1_epi16(2), half = _mm_set1_epi16(128);
+	for(; i + 16 <= count; i += 16)
+	{
+		unsigned char *block = pixels + i * channels;
+		__m128i r, g, b, a;
+		colorLoad(block, channels, r, g, b, a);
+		colorSplit(r, g, b, a);
+		__m128i co[2], y[2], cg[2];
+		for(int h = 0; h < 2; h++)
+		{
+			__m128i red = colorWiden(r, h), blue = colorWiden(b, h);
+			__m128i green = _mm_srli_epi16(_mm_add_epi16(colorWiden(g, h), one), 1);
+			__m128i tmp = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(red, blue), two), 2);
+			co[h] = _mm_add_epi16(half, _mm_srai_epi16(_mm_add_epi16(_mm_sub_epi16(red, blue), one), 1));
+			y[h] = _mm_add_epi16(green, tmp);
+			cg[h] = _mm_sub_epi16(_mm_add_epi16(half, green), tmp);
+		}
+		// packing saturates to 0-255 like clamp_byte
+		__m128i coBytes = _mm_packus_epi16(co[0], co[1]), yBytes = _mm_packus_epi16(y[0], y[1]), cgBytes = _mm_packus_epi16(cg[0], cg[1]);
+		if(channels == 3)
+		{
+			colorJoin(coBytes, yBytes, cgBytes, a);
+			colorStore(block, channels, coBytes, yBytes, cgBytes, a);
+		}
+		else
+		{
+			colorJoin(coBytes, cgBytes, a, yBytes);
+			colorStore(block, channels, coBytes, cgBytes, a, yBytes);
+		}
+	}
+#endif
+	if(i < count)
+		convert_RGB_to_YCoCg(pixels + i * channels, (int)(count - i), 1, channels);
+	return true;
+}
+
+// the other way around, back to RGB(A)
+inline bool convertYCoCgToRgb(unsigned char *pixels, int width, int height, int channels, bool avx2 = true)
+{
+	if(!pixels || width < 1 || height < 1 || channels < 3 || channels > 4)
+		return false;
+	size_t count = (size_t)width * height, i = 0;
+#ifdef COLOR_CONVERSION_AVX2
+	if(avx2 && cpuHasAvx2())
+		i = convertYCoCgToRgbAvx2(pixels, count, channels);
+#endif
+#ifdef COLOR_CONVERSION_SSE2
+	const __m128i half = _mm_set1_epi16(128);
+	for(; i + 16 <= count; i += 16)
+	{
+		unsigned char *block = pixels + i * channels;
+		__m128i x0, x1, x2, x3;
+		colorLoad(block, channels, x0, x1, x2, x3);
+		colorSplit(x0, x1, x2, x3);
+		// Co, Y, Cg, nothing or Co, Cg, alpha, Y
+		__m128i coBytes = x0, yBytes = channels == 3 ? x1 : x3, cgBytes = channels == 3 ? x2 : x1, rest = channels == 3 ? x3 : x2;
+		__m128i r[2], g[2], b[2];
+		for(int h = 0; h < 2; h++)
+		{
+			__m128i co = _mm_sub_epi16(colorWiden(coBytes, h), half), cg = _mm_sub_epi16(colorWiden(cgBytes, h), half);
+			__m128i y = colorWiden(yBytes, h);
+			r[h] = _mm_sub_epi16(_mm_add_epi16(y, co), cg);
+			g[h] = _mm_add_epi16(y, cg);
+			b[h] = _mm_sub_epi16(_mm_sub_epi16(y, co), cg);
+		}
+		__m128i red = _mm_packus_epi16(r[0], r[1]), green = _mm_packus_epi16(g[0], g[1]), blue = _mm_packus_epi16(b[0], b[1]);
+		colorJoin(red, green, blue, rest);
+		colorStore(block, channels, red, green, blue, rest);
+	}
+#endif
+	if(i < count)
+		convert_YCoCg_to_RGB(pixels + i * channels, (int)(count - i), 1, channels);
+	return true;
+}
+
+// every channel but alpha (the last of 2 or 4) from 0-255 to 16-235, false for an empty image
+inline bool scaleRgbToNtscSafe(unsigned char *pixels, int width, int height, int channels, bool avx2 = true)
+{
+	if(!pixels || width < 1 || height < 1 || channels < 1)
+		return false;
+	size_t bytes = (size_t)width * height * channels, i = 0;
+#ifdef COLOR_CONVERSION_AVX2
+	if(avx2 && channels <= 4 && cpuHasAvx2())
+		i = scaleRgbToNtscSafeAvx2(pixels, bytes, channels);
+#endif
+#ifdef COLOR_CONVERSION_SSE2
+	// the reference's table, (235.499 - 15.501) * c / 255 + 15.501 rounded down, is (28268 * c + 16 * 31763) >> 15 for every byte c;
+	// a block of 16 bytes starts on a pixel, so the alpha bytes sit at the same places in every block
+	if(channels <= 4)
+	{
+		const __m128i factors = _mm_setr_epi16(28268, 31763, 28268, 31763, 28268, 31763, 28268, 31763);
+		const __m128i sixteen = _mm_set1_epi16(16);
+		const __m128i alpha = channels == 2 ? _mm_set1_epi16((short)0xFF00)
+			: (channels == 4 ? _mm_set1_epi32((int)0xFF000000) : _mm_setzero_si128());
+		for(; i + 16 <= bytes; i += 16)
+		{
+			__m128i source = _mm_loadu_si128((const __m128i *)(pixels + i));
+			__m128i words[2];
+			for(int h = 0; h < 2; h++)
+			{
+				__m128i c = colorWiden(source, h);
+				__m128i low = _mm_srai_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(c, sixteen), factors), 15);
+				__m128i high = _mm_srai_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(c, sixteen), factors), 15);
+				words[h] = _mm_packs_epi32(low, high);
+			}
+			__m128i scaled = _mm_packus_epi16(words[0], words[1]);
+			_mm_storeu_si128((__m128i *)(pixels + i), _mm_or_si128(_mm_andnot_si128(alpha, scaled), _mm_and_si128(alpha, source)));
+		}
+	}
+#endif
+	// with an odd number of channels every byte is scaled, so the rest need not start on a pixel
+	if(i < bytes)
+	{
+		int restChannels = (channels & 1) ? 1 : channels;
+		scale_image_RGB_to_NTSC_safe(pixels + i, (int)((bytes - i) / restChannels), 1, restChannels);
+	}
+	return true;
+}
+#endif
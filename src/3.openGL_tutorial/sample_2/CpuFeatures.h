@@ -0,0 +1,44 @@
+// WHAT THE PROCESSOR CAN DO BEYOND WHAT THE COMPILER TARGETS FOR THE WHOLE GAME: A KERNEL WITH AN AVX2 VERSION COMPILES THAT
+// VERSION ALONE FOR AVX2 (CPU_FEATURES_AVX2_TARGET ON EACH OF ITS FUNCTIONS) AND ONLY CALLS IT WHEN cpuHasAvx2() SAYS SO,
+// SO THE SAME BUILD STILL RUNS ON PROCESSORS WITHOUT IT
+
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+// GCC and Clang compile single functions for AVX2 with the target attribute, MSVC compiles the intrinsics anywhere on x64
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CPU_FEATURES_AVX2
+#define CPU_FEATURES_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define CPU_FEATURES_AVX2
+#define CPU_FEATURES_AVX2_TARGET
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+#ifdef CPU_FEATURES_AVX2
+// can the processor run AVX2, and does the system save the wider registers? asked the first time only
+inline bool cpuHasAvx2()
+{
+#ifdef _MSC_VER
+	static const bool avx2 = []
+	{
+		int info[4];
+		__cpuid(info, 0);
+		if(info[0] < 7)
+			return false;
+		// OSXSAVE and AVX, then the system saving the SSE and AVX registers
+		__cpuid(info, 1);
+		if((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+			return false;
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+	}();
+#else
+	static const bool avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+	return avx2;
+}
+#endif
+#endif
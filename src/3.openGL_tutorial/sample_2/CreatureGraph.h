@@ -0,0 +1,152 @@
+// THE CUBES OF SVEN AND OF EVERY CHASING CREATURE AS ONE SCENE GRAPH (SEE SceneGraph.h)
+// EACH CREATURE IS A RIG: A ROOT NODE PLACED AT ITS POSITION, A FEW JOINTS THAT ANIMATE (TAIL, HIPS)
+// AND THE PARTS HANGING OFF THEM. THE RIGS ARE BUILT ONCE BY THE rig* FUNCTIONS IN "Source.cpp",
+// AFTER THAT A FRAME ONLY POSES THE ROOTS AND JOINTS OF THE CREATURES ON SCREEN, AND ONE THAT STOOD STILL COSTS NOTHING
+
+#ifndef CREATURE_GRAPH_H
+#define CREATURE_GRAPH_H
+
+#include <glm/glm.hpp>
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "NormalMatrix.h"
+#include "SceneGraph.h"
+
+// WHAT A PART IS TEXTURED WITH, TURNED INTO A TEXTURE EVERY FRAME SINCE HORROR MODE SWAPS SOME OF THEM
+enum CreatureSkin {
+	SKIN_SVEN_HEAD,
+	SKIN_SVEN_BODY,
+	SKIN_SHEEP_HEAD,
+	SKIN_SHEEP_BODY,
+	SKIN_ZOMBIE_HEAD,
+	SKIN_ZOMBIE_BODY,
+	SKIN_ZOMBIE_LEG,
+	SKIN_PODZOL,
+	CREATURE_SKIN_COUNT
+};
+
+// WHEN A PART IS DRAWN, THE ZOMBIE LOOKS DIFFERENT ONCE IT STARTS CHASING
+enum CreaturePartMode {
+	PART_ALWAYS,
+	PART_CALM,
+	PART_HORROR
+};
+
+class CreatureGraph
+{
+public:
+	// the most animated joints of one rig
+	static const unsigned int MAX_JOINTS = 3;
+
+	struct Part
+	{
+		unsigned int node;
+		unsigned char skin;
+		unsigned char mode;
+	};
+
+	struct Rig
+	{
+		unsigned int root;
+		unsigned int joints[MAX_JOINTS];
+		// the rig's nodes are graph nodes firstNode to firstNode + nodeCount - 1
+		unsigned int firstNode;
+		unsigned int nodeCount;
+		// the rig's parts are parts[firstPart] to parts[firstPart + partCount - 1]
+		unsigned int firstPart;
+		unsigned int partCount;
+	};
+
+	SceneGraph graph;
+	std::vector<Rig> rigs;
+	std::vector<Part> parts;
+	// rigs of the creatures that passed the frustum test this frame, the only ones update() brings up to date
+	std::vector<unsigned int> visible;
+
+	// start a rig, the nodes and parts added until the next one belong to it, returns its index
+	unsigned int beginRig()
+	{
+		Rig rig;
+		rig.root = 0;
+		rig.firstNode = graph.size();
+		rig.nodeCount = 0;
+		for(unsigned int i = 0; i < MAX_JOINTS; i++)
+			rig.joints[i] = 0;
+		rig.firstPart = parts.size();
+		rig.partCount = 0;
+		rigs.push_back(rig);
+		return rigs.size() - 1;
+	}
+
+	// a node that is not drawn itself, the root or a joint
+	unsigned int addNode(int parent, const glm::mat4 &local)
+	{
+		rigs.back().nodeCount++;
+		return graph.add(parent, local);
+	}
+
+	// a cube of the current rig
+	void addPart(int parent, const glm::mat4 &local, CreatureSkin skin, CreaturePartMode mode)
+	{
+		Part part;
+		part.node = addNode(parent, local);
+		part.skin = skin;
+		part.mode = mode;
+		parts.push_back(part);
+		normals.push_back(glm::mat3());
+		normalStale.push_back(1);
+		rigs.back().partCount++;
+	}
+
+	// bring the world matrices of the visible rigs up to date
+	void update()
+	{
+		for(size_t v = 0; v < visible.size(); v++)
+		{
+			const Rig &rig = rigs[visible[v]];
+			graph.update(rig.firstNode, rig.firstNode + rig.nodeCount);
+			unsigned int end = rig.firstPart + rig.partCount;
+			for(unsigned int p = rig.firstPart; p < end; p++)
+				normalStale[p] |= graph.hasMoved(parts[p].node);
+		}
+	}
+
+	// normal matrix of a part as of the last update(), only worked out for parts that are drawn
+	const glm::mat3 &normal(unsigned int part)
+	{
+		if(normalStale[part])
+		{
+			normals[part] = rotateScaleNormalMatrix(graph.world(parts[part].node));
+			normalStale[part] = 0;
+		}
+		return normals[part];
+	}
+
+	// were the rigs built for creatures of these models, one rig per mob after Sven's?
+	bool builtFor(const std::vector<unsigned char> &models) const
+	{
+		return !rigs.empty() && models == mobModels;
+	}
+
+	// throw away every rig, remembering which mob models the next ones are built for
+	void clear(const std::vector<unsigned char> &models)
+	{
+		graph.clear();
+		rigs.clear();
+		parts.clear();
+		normals.clear();
+		normalStale.clear();
+		visible.clear();
+		mobModels = models;
+	}
+
+private:
+	std::vector<glm::mat3> normals;
+	// set when a part moved, cleared when its normal matrix is worked out again
+	std::vector<unsigned char> normalStale;
+	std::vector<unsigned char> mobModels;
+};
+#endif
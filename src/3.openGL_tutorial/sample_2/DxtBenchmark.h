@@ -0,0 +1,281 @@
+// TIMES THE DXT COMPRESSOR (SEE DxtCompressor.h) ON THE GAME'S TEXTURES AGAINST THE REFERENCE IN includes/image_DXT.c,
+// ON ONE THREAD WITH THE SSE2 KERNEL AND WITH THE AVX2 ONE (WHEN THE PROCESSOR HAS IT) AND SPREAD OVER A THREAD PER CORE,
+// AND CHECKS THAT EVERY KERNEL MAKES THE SAME BLOCKS AS THE REFERENCE FOR EVERY MIPMAP LEVEL
+// WRITES MEGABYTES OF PIXELS PER SECOND AND THE ROOT MEAN SQUARE ERROR OF BOTH AGAINST THE SOURCE PIXELS AS JSON
+// ONLY USED BY THE HEADLESS BENCHMARK BUILD (SAMPLE_2_BENCHMARK), RUN WITH "--dxt"
+
+#ifndef DXT_BENCHMARK_H
+#define DXT_BENCHMARK_H
+
+#include <image_DXT.h>
+#include <image_helper.h>
+#include <learnopengl/filesystem.h>
+#include <stb_image.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include "Benchmark.h"
+#include "DxtCompressor.h"
+#include "JobSystem.h"
+
+class DxtBenchmark
+{
+public:
+	DxtBenchmark(const BenchmarkOptions &options) : options(options) {}
+
+	bool run()
+	{
+		return writeBenchmarkReport(options, [this](std::ostream &out)
+		{
+			return run(out);
+		});
+	}
+
+private:
+	bool run(std::ostream &out) const
+	{
+		const char *files[] = { "handle.jpg", "sky.jpg", "bars.png", "dirt.jpg", "bloody.png", "svenBody.jpg", "svenHead.png",
+			"waterSheepBody.jpg", "sheepHead.jpg", "waterSheepFace.png", "wood.jpg", "obsidian.png", "leaf.png", "netherack.png",
+			"zombieBody.jpg", "zombieHead.jpg", "denim.jpeg", "podzol.jpg", "gameover.png", "gamewin.jpg", "glowstone.jpeg", "portal.jpeg" };
+		const unsigned int fileCount = sizeof(files) / sizeof(files[0]);
+		const unsigned int repeats = 3;
+		JobSystem jobs(JobSystem::workersPerCore());
+		bool avx2 = hasAvx2();
+
+		beginKernelReport(out);
+		out << "\t\"avx2\": " << (avx2 ? "true" : "false") << ",\n"
+			<< "\t\"threads\": " << jobs.threadCount() << ",\n"
+			<< "\t\"files\": [\n";
+		double megabytes = 0.0, referenceSeconds = 0.0, singleSeconds = 0.0, avx2Seconds = 0.0, threadedSeconds = 0.0;
+		bool allIdentical = true;
+		for(unsigned int f = 0; f < fileCount; f++)
+		{
+			std::string path = FileSystem::getPath(std::string("resources/textures/") + files[f]);
+			int width, height, channels;
+			unsigned char *pixels = stbi_load(path.c_str(), &width, &height, &channels, 0);
+			if(!pixels)
+			{
+				std::cout << "Error loading " << path << std::endl;
+				return false;
+			}
+			// the texture cache's choice
+			bool alpha = channels == 4;
+			size_t size = dxtSize(width, height, alpha);
+			std::vector<unsigned char> reference(size), single(size), wide(size), threaded(size);
+
+			double referenceMs = 1e30, singleMs = 1e30, avx2Ms = 1e30, threadedMs = 1e30;
+			for(unsigned int repeat = 0; repeat < repeats; repeat++)
+			{
+				auto start = std::chrono::steady_clock::now();
+				int referenceSize = 0;
+				unsigned char *blocks = alpha ? convert_image_to_DXT5(pixels, width, height, channels, &referenceSize)
+					: convert_image_to_DXT1(pixels, width, height, channels, &referenceSize);
+				auto referenceEnd = std::chrono::steady_clock::now();
+				memcpy(&reference[0], blocks, size);
+				free(blocks);
+
+				auto singleStart = std::chrono::steady_clock::now();
+				compressSingle(pixels, width, height, channels, alpha, &single[0], false);
+				auto singleEnd = std::chrono::steady_clock::now();
+				if(avx2)
+					compressSingle(pixels, width, height, channels, alpha, &wide[0], true);
+				auto avx2End = std::chrono::steady_clock::now();
+				compressDxt(pixels, width, height, channels, alpha, &threaded[0], &jobs);
+				auto threadedEnd = std::chrono::steady_clock::now();
+
+				referenceMs = std::min(referenceMs, std::chrono::duration<double, std::milli>(referenceEnd - start).count());
+				singleMs = std::min(singleMs, std::chrono::duration<double, std::milli>(singleEnd - singleStart).count());
+				avx2Ms = std::min(avx2Ms, std::chrono::duration<double, std::milli>(avx2End - singleEnd).count());
+				threadedMs = std::min(threadedMs, std::chrono::duration<double, std::milli>(threadedEnd - avx2End).count());
+			}
+			bool identical = reference == single && (!avx2 || reference == wide) && reference == threaded
+				&& sameMipmaps(pixels, width, height, channels, alpha, false) && (!avx2 || sameMipmaps(pixels, width, height, channels, alpha, true));
+			double referenceError = rootMeanSquareError(pixels, width, height, channels, alpha, reference);
+			double singleError = rootMeanSquareError(pixels, width, height, channels, alpha, single);
+			stbi_image_free(pixels);
+
+			double fileMegabytes = (double)width * height * channels / (1024.0 * 1024.0);
+			megabytes += fileMegabytes;
+			referenceSeconds += referenceMs / 1000.0;
+			singleSeconds += singleMs / 1000.0;
+			avx2Seconds += avx2Ms / 1000.0;
+			threadedSeconds += threadedMs / 1000.0;
+			allIdentical = allIdentical && identical;
+			out << "\t\t{ \"file\": \"" << files[f] << "\", \"width\": " << width << ", \"height\": " << height
+				<< ", \"format\": \"" << (alpha ? "DXT5" : "DXT1") << "\", \"referenceMBps\": " << fileMegabytes * 1000.0 / referenceMs
+				<< ", \"sse2MBps\": " << fileMegabytes * 1000.0 / singleMs;
+			if(avx2)
+				out << ", \"avx2MBps\": " << fileMegabytes * 1000.0 / avx2Ms;
+			out << ", \"threadedMBps\": " << fileMegabytes * 1000.0 / threadedMs
+				<< ", \"referenceRmse\": " << referenceError << ", \"sse2Rmse\": " << singleError
+				<< ", \"identical\": " << (identical ? "true" : "false") << " }" << (f + 1 < fileCount ? "," : "") << "\n";
+		}
+		out << "\t],\n"
+			<< "\t\"total\": { \"megabytes\": " << megabytes << ", \"referenceMBps\": " << megabytes / referenceSeconds
+			<< ", \"sse2MBps\": " << megabytes / singleSeconds;
+		if(avx2)
+			out << ", \"avx2MBps\": " << megabytes / avx2Seconds;
+		out << ", \"threadedMBps\": " << megabytes / threadedSeconds << ", \"speedup\": " << referenceSeconds / singleSeconds;
+		if(avx2)
+			out << ", \"avx2Speedup\": " << referenceSeconds / avx2Seconds;
+		out << ", \"threadedSpeedup\": " << referenceSeconds / threadedSeconds
+			<< ", \"identical\": " << (allIdentical ? "true" : "false") << " }\n"
+			<< "}" << std::endl;
+		return true;
+	}
+
+	// can the AVX2 kernel run here?
+	static bool hasAvx2()
+	{
+#ifdef DXT_COMPRESSOR_AVX2
+		return cpuHasAvx2();
+#else
+		return false;
+#endif
+	}
+
+	// the whole image on this thread with the SSE2 kernel, or the AVX2 one if avx2 (compressDxt() picks one by itself)
+	static void compressSingle(const unsigned char *pixels, int width, int height, int channels, bool alpha, unsigned char *blocks, bool avx2)
+	{
+		int blockRows = (height + 3) / 4;
+#ifdef DXT_COMPRESSOR_AVX2
+		if(avx2)
+		{
+			compressDxtRowsAvx2(pixels, width, height, channels, alpha, blocks, 0, blockRows);
+			return;
+		}
+#endif
+#ifdef DXT_COMPRESSOR_SSE2
+		compressDxtRows(pixels, width, height, channels, alpha, blocks, 0, blockRows);
+#else
+		compressDxtRowsReference(pixels, width, height, channels, alpha, blocks, 0, blockRows);
+#endif
+	}
+
+	// does the kernel make the same blocks as the reference for every smaller mipmap level too? (the odd sizes, partial and 1x1 blocks)
+	static bool sameMipmaps(const unsigned char *pixels, int width, int height, int channels, bool alpha, bool avx2)
+	{
+		std::vector<unsigned char> level(pixels, pixels + (size_t)width * height * channels), smaller;
+		while(width > 1 || height > 1)
+		{
+			int nextWidth = width > 1 ? width / 2 : 1;
+			int nextHeight = height > 1 ? height / 2 : 1;
+			smaller.resize((size_t)nextWidth * nextHeight * channels);
+			mipmap_image(&level[0], width, height, channels, &smaller[0], width > 1 ? 2 : 1, height > 1 ? 2 : 1);
+			level.swap(smaller);
+			width = nextWidth;
+			height = nextHeight;
+
+			int size = 0;
+			unsigned char *reference = alpha ? convert_image_to_DXT5(&level[0], width, height, channels, &size)
+				: convert_image_to_DXT1(&level[0], width, height, channels, &size);
+			std::vector<unsigned char> blocks(dxtSize(width, height, alpha));
+			compressSingle(&level[0], width, height, channels, alpha, &blocks[0], avx2);
+			bool same = (size_t)size == blocks.size() && memcmp(reference, &blocks[0], size) == 0;
+			free(reference);
+			if(!same)
+				return false;
+		}
+		return true;
+	}
+
+	// error of the decompressed blocks against the source, over red, green, blue (and alpha for DXT5)
+	static double rootMeanSquareError(const unsigned char *pixels, int width, int height, int channels, bool alpha,
+		const std::vector<unsigned char> &blocks)
+	{
+		int step = channels < 3 ? 0 : 1;
+		int compared = alpha ? 4 : 3;
+		double sum = 0.0;
+		const unsigned char *block = &blocks[0];
+		for(int y = 0; y < height; y += 4)
+		{
+			for(int x = 0; x < width; x += 4)
+			{
+				unsigned char decoded[16][4];
+				decodeBlock(block, alpha, decoded);
+				block += alpha ? 16 : 8;
+				for(int j = 0; j < 4 && y + j < height; j++)
+				{
+					for(int i = 0; i < 4 && x + i < width; i++)
+					{
+						const unsigned char *pixel = pixels + ((size_t)(y + j) * width + x + i) * channels;
+						int source[4] = { pixel[0], pixel[step], pixel[step * 2], (channels & 1) == 0 ? pixel[channels - 1] : 255 };
+						for(int c = 0; c < compared; c++)
+						{
+							double difference = source[c] - decoded[j * 4 + i][c];
+							sum += difference * difference;
+						}
+					}
+				}
+			}
+		}
+		return sqrt(sum / ((double)width * height * compared));
+	}
+
+public:
+	// the 16 RGBA pixels of a block, as the graphics card expands them
+	static void decodeBlock(const unsigned char *block, bool alpha, unsigned char decoded[16][4])
+	{
+		const unsigned char *color = alpha ? block + 8 : block;
+		int c0 = color[0] | (color[1] << 8), c1 = color[2] | (color[3] << 8);
+		int palette[4][3];
+		for(int k = 0; k < 2; k++)
+		{
+			int c = k == 0 ? c0 : c1;
+			int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+			palette[k][0] = (r << 3) | (r >> 2);
+			palette[k][1] = (g << 2) | (g >> 4);
+			palette[k][2] = (b << 3) | (b >> 2);
+		}
+		// DXT5 color blocks always have four colors, DXT1 ones only when c0 > c1
+		bool fourColors = alpha || c0 > c1;
+		for(int c = 0; c < 3; c++)
+		{
+			if(fourColors)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+			else
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+				palette[3][c] = 0;
+			}
+		}
+		unsigned int colorBits = color[4] | (color[5] << 8) | (color[6] << 16) | ((unsigned int)color[7] << 24);
+
+		int alphas[8];
+		unsigned long long alphaBits = 0;
+		if(alpha)
+		{
+			alphas[0] = block[0];
+			alphas[1] = block[1];
+			for(int k = 2; k < 8; k++)
+			{
+				if(alphas[0] > alphas[1])
+					alphas[k] = ((8 - k) * alphas[0] + (k - 1) * alphas[1]) / 7;
+				else
+					alphas[k] = k < 6 ? ((6 - k) * alphas[0] + (k - 1) * alphas[1]) / 5 : (k == 6 ? 0 : 255);
+			}
+			for(int k = 0; k < 6; k++)
+				alphaBits |= (unsigned long long)block[2 + k] << (8 * k);
+		}
+
+		for(int p = 0; p < 16; p++)
+		{
+			int index = (colorBits >> (p * 2)) & 3;
+			for(int c = 0; c < 3; c++)
+				decoded[p][c] = palette[index][c];
+			decoded[p][3] = alpha ? alphas[(alphaBits >> (p * 3)) & 7] : 255;
+		}
+	}
+
+private:
+	BenchmarkOptions options;
+};
+#endif
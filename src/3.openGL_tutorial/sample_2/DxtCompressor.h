@@ -0,0 +1,646 @@
+// DXT1/DXT5 COMPRESSION OF A WHOLE IMAGE, BLOCK FOR BLOCK THE SAME AS convert_image_to_DXT1/5 IN includes/image_DXT.c
+// (THE REFERENCE IT IS CHECKED AGAINST, SEE DxtBenchmark.h), BUT EVERY 4x4 BLOCK IS WORKED ON FOUR PIXELS AT A TIME WITH SSE2,
+// OR TWO BLOCKS AT A TIME, EIGHT PIXELS PER REGISTER, WITH AVX2 ON PROCESSORS THAT HAVE IT (SEE CpuFeatures.h),
+// AND THE ROWS OF BLOCKS CAN BE SPREAD OVER A JobSystem
+// THE FLOATING POINT STEPS ARE DONE IN THE SAME ORDER AS IN THE REFERENCE, SO THE BLOCKS COME OUT BIT FOR BIT THE SAME
+// (AND A TEXTURE CACHE WRITTEN BY EITHER ONE STAYS VALID)
+
+#ifndef DXT_COMPRESSOR_H
+#define DXT_COMPRESSOR_H
+
+#include <image_DXT.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "ColorConversion.h"
+#include "CpuFeatures.h"
+#include "JobSystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DXT_COMPRESSOR_SSE2
+#include <emmintrin.h>
+#ifdef CPU_FEATURES_AVX2
+#define DXT_COMPRESSOR_AVX2
+#endif
+#endif
+
+// bytes of an image compressed to DXT5 (alpha, 16 per 4x4 block) or DXT1 (8 per block)
+inline size_t dxtSize(int width, int height, bool alpha)
+{
+	return (size_t)((width + 3) / 4) * ((height + 3) / 4) * (alpha ? 16 : 8);
+}
+
+// compress the block rows first to last - 1 with the reference: a strip of 4 pixel rows holds exactly the pixels of its blocks
+inline void compressDxtRowsReference(const unsigned char *pixels, int width, int height, int channels, bool alpha, unsigned char *blocks,
+	int first, int last)
+{
+	size_t rowBytes = dxtSize(width, 1, alpha);
+	for(int row = first; row < last; row++)
+	{
+		int rows = height - row * 4 < 4 ? height - row * 4 : 4;
+		const unsigned char *strip = pixels + (size_t)row * 4 * width * channels;
+		int size = 0;
+		unsigned char *compressed = alpha ? convert_image_to_DXT5(strip, width, rows, channels, &size)
+			: convert_image_to_DXT1(strip, width, rows, channels, &size);
+		if(compressed)
+		{
+			memcpy(blocks + row * rowBytes, compressed, size);
+			free(compressed);
+		}
+	}
+}
+
+#ifdef DXT_COMPRESSOR_SSE2
+// the 16 pixels of a block, channel by channel, four pixels per register
+struct DxtBlock
+{
+	__m128 r[4];
+	__m128 g[4];
+	__m128 b[4];
+	unsigned char a[16];
+};
+
+// the reference's helpers from image_DXT.c
+inline int dxtBitRange(int c, int fromBits, int toBits)
+{
+	int b = (1 << (fromBits - 1)) + c * ((1 << toBits) - 1);
+	return (b + (b >> fromBits)) >> fromBits;
+}
+
+inline int dxtRgbTo565(int r, int g, int b)
+{
+	return (dxtBitRange(r, 8, 5) << 11) | (dxtBitRange(g, 8, 6) << 5) | dxtBitRange(b, 8, 5);
+}
+
+inline void dxtRgbFrom565(int c, int rgb[3])
+{
+	rgb[0] = dxtBitRange((c >> 11) & 31, 5, 8);
+	rgb[1] = dxtBitRange((c >> 5) & 63, 6, 8);
+	rgb[2] = dxtBitRange(c & 31, 5, 8);
+}
+
+// the sums of the lanes of a, b, c and d, in that order
+inline __m128 dxtSums(__m128 a, __m128 b, __m128 c, __m128 d)
+{
+	_MM_TRANSPOSE4_PS(a, b, c, d);
+	return _mm_add_ps(_mm_add_ps(a, b), _mm_add_ps(c, d));
+}
+
+inline float dxtMin(__m128 v)
+{
+	v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+	v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtss_f32(v);
+}
+
+inline float dxtMax(__m128 v)
+{
+	v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+	v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtss_f32(v);
+}
+
+// move bit i of a 16 bit value to bit 2i
+inline uint32_t dxtSpreadBits(uint32_t bits)
+{
+	bits = (bits | (bits << 8)) & 0x00FF00FFu;
+	bits = (bits | (bits << 4)) & 0x0F0F0F0Fu;
+	bits = (bits | (bits << 2)) & 0x33333333u;
+	bits = (bits | (bits << 1)) & 0x55555555u;
+	return bits;
+}
+
+// the RGBA of the 16 pixels of the block at pixel (x, y), row by row, read like the reference: grey images repeat their
+// one channel, images without alpha get 255, and the pixels past the right or bottom edge repeat the block's first pixel
+inline void loadDxtPixels(const unsigned char *pixels, int width, int height, int channels, int x, int y, uint32_t rgba[16])
+{
+	int columns = width - x < 4 ? width - x : 4;
+	int rows = height - y < 4 ? height - y : 4;
+	if(columns == 4 && rows == 4 && channels >= 3)
+	{
+		// the common case, a whole block of an RGB or RGBA image
+		for(int j = 0; j < 4; j++)
+		{
+			const unsigned char *pixel = pixels + ((size_t)(y + j) * width + x) * channels;
+			if(channels == 4)
+				memcpy(&rgba[j * 4], pixel, 16);
+			else
+			{
+				// four RGB pixels are three words: RGBR GBRG BRGB
+				uint32_t words[3];
+				memcpy(words, pixel, 12);
+				rgba[j * 4] = words[0] | 0xFF000000u;
+				rgba[j * 4 + 1] = (words[0] >> 24) | (words[1] << 8) | 0xFF000000u;
+				rgba[j * 4 + 2] = (words[1] >> 16) | (words[2] << 16) | 0xFF000000u;
+				rgba[j * 4 + 3] = (words[2] >> 8) | 0xFF000000u;
+			}
+		}
+		return;
+	}
+
+	int step = channels < 3 ? 0 : 1;
+	bool hasAlpha = (channels & 1) == 0;
+	for(int j = 0; j < 4; j++)
+	{
+		for(int i = 0; i < 4; i++)
+		{
+			if(i >= columns || j >= rows)
+			{
+				rgba[j * 4 + i] = rgba[0];
+				continue;
+			}
+			const unsigned char *pixel = pixels + ((size_t)(y + j) * width + x + i) * channels;
+			uint32_t alpha = hasAlpha ? pixel[channels - 1] : 255;
+			rgba[j * 4 + i] = pixel[0] | (pixel[step] << 8) | (pixel[step * 2] << 16) | (alpha << 24);
+		}
+	}
+}
+
+inline void loadDxtBlock(const unsigned char *pixels, int width, int height, int channels, int x, int y, DxtBlock &block)
+{
+	uint32_t rgba[16];
+	loadDxtPixels(pixels, width, height, channels, x, y, rgba);
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+	for(int q = 0; q < 4; q++)
+	{
+		__m128i four = _mm_loadu_si128((const __m128i *)&rgba[q * 4]);
+		block.r[q] = _mm_cvtepi32_ps(_mm_and_si128(four, byteMask));
+		block.g[q] = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(four, 8), byteMask));
+		block.b[q] = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(four, 16), byteMask));
+	}
+	for(int p = 0; p < 16; p++)
+		block.a[p] = rgba[p] >> 24;
+}
+
+// the average point and the direction of the color line of a block from its sums of r, g, b, rr, gg, bb, rg, rb and gb,
+// and 1 / the direction's length squared: the same steps as compute_color_line_STDEV() with USE_COV_MAT, the average
+// and three power iterations on the covariance matrix
+inline void dxtColorLine(const float sums[9], float point[3], float direction[3], float &scale)
+{
+	float sumR = sums[0], sumG = sums[1], sumB = sums[2], sumRR = sums[3];
+	float sumGG = sums[4], sumBB = sums[5], sumRG = sums[6], sumRB = sums[7], sumGB = sums[8];
+	const float inv16 = 1.0f / 16.0f;
+	sumR *= inv16;
+	sumG *= inv16;
+	sumB *= inv16;
+	sumRR -= 16.0f * sumR * sumR;
+	sumGG -= 16.0f * sumG * sumG;
+	sumBB -= 16.0f * sumB * sumB;
+	sumRG -= 16.0f * sumR * sumG;
+	sumRB -= 16.0f * sumR * sumB;
+	sumGB -= 16.0f * sumG * sumB;
+	point[0] = sumR;
+	point[1] = sumG;
+	point[2] = sumB;
+	float x = 1.0f, y = 2.718281828f, z = 3.141592654f;
+	for(int iteration = 0; iteration < 3; iteration++)
+	{
+		direction[0] = x * sumRR + y * sumRG + z * sumRB;
+		direction[1] = x * sumRG + y * sumGG + z * sumGB;
+		direction[2] = x * sumRB + y * sumGB + z * sumBB;
+		x = direction[0];
+		y = direction[1];
+		z = direction[2];
+	}
+	scale = 1.0f / (0.00001f + direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+}
+
+// the two end colors as 565, the larger one first, from the smallest and largest dot product of a pixel with the direction
+// (the end of LSE_master_colors_max_min() of the reference)
+inline void dxtEndColorsFromDots(const float point[3], const float direction[3], float scale, float dotMin, float dotMax, int &colorMax, int &colorMin)
+{
+	float offset = direction[0] * point[0] + direction[1] * point[1] + direction[2] * point[2];
+	dotMin -= offset;
+	dotMax -= offset;
+	dotMin *= scale;
+	dotMax *= scale;
+
+	int c0[3], c1[3];
+	for(int i = 0; i < 3; i++)
+	{
+		c0[i] = (int)(0.5f + point[i] + dotMax * direction[i]);
+		c0[i] = c0[i] < 0 ? 0 : (c0[i] > 255 ? 255 : c0[i]);
+		c1[i] = (int)(0.5f + point[i] + dotMin * direction[i]);
+		c1[i] = c1[i] < 0 ? 0 : (c1[i] > 255 ? 255 : c1[i]);
+	}
+	int i = dxtRgbTo565(c0[0], c0[1], c0[2]);
+	int j = dxtRgbTo565(c1[0], c1[1], c1[2]);
+	colorMax = i > j ? i : j;
+	colorMin = i > j ? j : i;
+}
+
+// the two end colors as 565, the larger one first (LSE_master_colors_max_min() of the reference)
+inline void dxtEndColors(const DxtBlock &block, int &colorMax, int &colorMin)
+{
+	// the channel sums and sums of products are whole numbers below 2^24, so they are exact in any order
+	__m128 r = _mm_setzero_ps(), g = r, b = r, rr = r, gg = r, bb = r, rg = r, rb = r, gb = r;
+	for(int q = 0; q < 4; q++)
+	{
+		r = _mm_add_ps(r, block.r[q]);
+		g = _mm_add_ps(g, block.g[q]);
+		b = _mm_add_ps(b, block.b[q]);
+		rr = _mm_add_ps(rr, _mm_mul_ps(block.r[q], block.r[q]));
+		gg = _mm_add_ps(gg, _mm_mul_ps(block.g[q], block.g[q]));
+		bb = _mm_add_ps(bb, _mm_mul_ps(block.b[q], block.b[q]));
+		rg = _mm_add_ps(rg, _mm_mul_ps(block.r[q], block.g[q]));
+		rb = _mm_add_ps(rb, _mm_mul_ps(block.r[q], block.b[q]));
+		gb = _mm_add_ps(gb, _mm_mul_ps(block.g[q], block.b[q]));
+	}
+	float sums[12];
+	_mm_storeu_ps(sums, dxtSums(r, g, b, rr));
+	_mm_storeu_ps(sums + 4, dxtSums(gg, bb, rg, rb));
+	_mm_storeu_ps(sums + 8, dxtSums(gb, _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()));
+	float point[3], direction[3], scale;
+	dxtColorLine(sums, point, direction, scale);
+
+	const __m128 dirR = _mm_set1_ps(direction[0]), dirG = _mm_set1_ps(direction[1]), dirB = _mm_set1_ps(direction[2]);
+	__m128 low = _mm_set1_ps(3.0e38f), high = _mm_set1_ps(-3.0e38f);
+	for(int q = 0; q < 4; q++)
+	{
+		__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dirR, block.r[q]), _mm_mul_ps(dirG, block.g[q])), _mm_mul_ps(dirB, block.b[q]));
+		low = _mm_min_ps(low, dot);
+		high = _mm_max_ps(high, dot);
+	}
+	dxtEndColorsFromDots(point, direction, scale, dxtMin(low), dxtMax(high), colorMax, colorMin);
+}
+
+// write the end colors of a color block and find the line from the first to the second, scaled so that a pixel's dot
+// product with it less offset runs from 0 to 1
+inline void dxtIndexLine(int colorMax, int colorMin, unsigned char *out, float line[3], float &offset)
+{
+	out[0] = colorMax & 255;
+	out[1] = (colorMax >> 8) & 255;
+	out[2] = colorMin & 255;
+	out[3] = (colorMin >> 8) & 255;
+
+	int c0[3], c1[3];
+	dxtRgbFrom565(colorMax, c0);
+	dxtRgbFrom565(colorMin, c1);
+	float length2 = 0.0f;
+	for(int i = 0; i < 3; i++)
+	{
+		line[i] = (float)(c1[i] - c0[i]);
+		length2 += line[i] * line[i];
+	}
+	if(length2 > 0.0f)
+		length2 = 1.0f / length2;
+	line[0] *= length2;
+	line[1] *= length2;
+	line[2] *= length2;
+	offset = line[0] * c0[0] + line[1] * c0[1] + line[2] * c0[2];
+}
+
+// write the 16 color indices from one bit per pixel for the steps above 1 (low) and for steps 1 and 2 (high): the order of
+// the four colors in a block is 0, 2, 3, 1
+inline void dxtColorIndices(uint32_t low, uint32_t high, unsigned char *out)
+{
+	uint32_t bits = dxtSpreadBits(low) | (dxtSpreadBits(high) << 1);
+	for(int i = 0; i < 4; i++)
+		out[i] = (bits >> (i * 8)) & 255;
+}
+
+// 8 bytes of color, compress_DDS_color_block() of the reference
+inline void compressDxtColor(const DxtBlock &block, unsigned char *out)
+{
+	int colorMax, colorMin;
+	dxtEndColors(block, colorMax, colorMin);
+	float line[3], offset;
+	dxtIndexLine(colorMax, colorMin, out, line, offset);
+
+	// where every pixel falls on the line from c0 to c1, rounded to 0..3
+	const __m128 lineR = _mm_set1_ps(line[0]), lineG = _mm_set1_ps(line[1]), lineB = _mm_set1_ps(line[2]);
+	const __m128 offsets = _mm_set1_ps(offset), three = _mm_set1_ps(3.0f), half = _mm_set1_ps(0.5f);
+	__m128i steps[4];
+	for(int q = 0; q < 4; q++)
+	{
+		__m128 dot = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(lineR, block.r[q]), _mm_mul_ps(lineG, block.g[q])), _mm_mul_ps(lineB, block.b[q])), offsets);
+		steps[q] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(dot, three), half));
+	}
+	// the 16 steps as bytes (saturating, so the clamp to 0..3 still sees what is out of range), one bit per pixel from movemask
+	__m128i step = _mm_packs_epi16(_mm_packs_epi32(steps[0], steps[1]), _mm_packs_epi32(steps[2], steps[3]));
+	uint32_t low = _mm_movemask_epi8(_mm_cmpgt_epi8(step, _mm_set1_epi8(1)));
+	uint32_t high = _mm_movemask_epi8(_mm_and_si128(_mm_cmpgt_epi8(step, _mm_setzero_si128()), _mm_cmplt_epi8(step, _mm_set1_epi8(3))));
+	dxtColorIndices(low, high, out + 4);
+}
+
+// write the largest and smallest alpha of a block and return the scale from alpha less the smallest one to the steps 0..7;
+// a flat block uses index 0 everywhere, which is where the reference's 0 * infinity ends up on x86 as well
+inline float dxtAlphaRange(const unsigned char a[16], unsigned char *out)
+{
+	int a0 = a[0], a1 = a[0];
+	for(int p = 1; p < 16; p++)
+	{
+		a0 = a[p] > a0 ? a[p] : a0;
+		a1 = a[p] < a1 ? a[p] : a1;
+	}
+	out[0] = a0;
+	out[1] = a1;
+	return a0 == a1 ? 0.0f : 7.9999f / (a0 - a1);
+}
+
+// write the 16 alpha indices from the steps
+inline void dxtAlphaIndices(const int steps[16], unsigned char *out)
+{
+	// the order of the eight alphas in a block
+	static const uint64_t swizzle[8] = { 1, 7, 6, 5, 4, 3, 2, 0 };
+	uint64_t bits = 0;
+	for(int p = 0; p < 16; p++)
+		bits |= swizzle[steps[p] & 7] << (p * 3);
+	for(int i = 0; i < 6; i++)
+		out[i] = (bits >> (i * 8)) & 255;
+}
+
+// 8 bytes of alpha, compress_DDS_alpha_block() of the reference
+inline void compressDxtAlpha(const DxtBlock &block, unsigned char *out)
+{
+	const __m128 scale = _mm_set1_ps(dxtAlphaRange(block.a, out));
+	const __m128i low = _mm_set1_epi32(out[1]), zero = _mm_setzero_si128();
+	int steps[16];
+	for(int q = 0; q < 4; q++)
+	{
+		int packed;
+		memcpy(&packed, &block.a[q * 4], sizeof(packed));
+		__m128i four = _mm_cvtsi32_si128(packed);
+		four = _mm_unpacklo_epi16(_mm_unpacklo_epi8(four, zero), zero);
+		__m128 value = _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(four, low)), scale);
+		_mm_storeu_si128((__m128i *)&steps[q * 4], _mm_cvttps_epi32(value));
+	}
+	dxtAlphaIndices(steps, out + 2);
+}
+
+// the block at pixel (x, y), alpha first for DXT5
+inline void compressDxtBlock(const unsigned char *pixels, int width, int height, int channels, bool alpha, int x, int y, unsigned char *out)
+{
+	DxtBlock block;
+	loadDxtBlock(pixels, width, height, channels, x, y, block);
+	if(alpha)
+	{
+		compressDxtAlpha(block, out);
+		compressDxtColor(block, out + 8);
+	}
+	else
+		compressDxtColor(block, out);
+}
+
+inline void compressDxtRows(const unsigned char *pixels, int width, int height, int channels, bool alpha, unsigned char *blocks,
+	int first, int last)
+{
+	size_t blockBytes = alpha ? 16 : 8;
+	unsigned char *out = blocks + first * dxtSize(width, 1, alpha);
+	for(int y = first * 4; y < last * 4 && y < height; y += 4)
+	{
+		for(int x = 0; x < width; x += 4)
+		{
+			compressDxtBlock(pixels, width, height, channels, alpha, x, y, out);
+			out += blockBytes;
+		}
+	}
+}
+
+#ifdef DXT_COMPRESSOR_AVX2
+// two blocks side by side, eight pixels per register: the left block in the low half, the right one in the high half
+struct DxtBlockPair
+{
+	__m256 r[4];
+	__m256 g[4];
+	__m256 b[4];
+	unsigned char a[2][16];
+};
+
+// the sums of the lanes of a, b, c and d of both halves, the left block's first
+CPU_FEATURES_AVX2_TARGET inline __m256 dxtSumsPair(__m256 a, __m256 b, __m256 c, __m256 d)
+{
+	// _MM_TRANSPOSE4_PS in each half
+	__m256 ab = _mm256_unpacklo_ps(a, b), cd = _mm256_unpacklo_ps(c, d);
+	__m256 abHigh = _mm256_unpackhi_ps(a, b), cdHigh = _mm256_unpackhi_ps(c, d);
+	a = _mm256_shuffle_ps(ab, cd, _MM_SHUFFLE(1, 0, 1, 0));
+	b = _mm256_shuffle_ps(ab, cd, _MM_SHUFFLE(3, 2, 3, 2));
+	c = _mm256_shuffle_ps(abHigh, cdHigh, _MM_SHUFFLE(1, 0, 1, 0));
+	d = _mm256_shuffle_ps(abHigh, cdHigh, _MM_SHUFFLE(3, 2, 3, 2));
+	return _mm256_add_ps(_mm256_add_ps(a, b), _mm256_add_ps(c, d));
+}
+
+// the blocks at pixel (x, y) and (x + 4, y), which must both be in the image
+CPU_FEATURES_AVX2_TARGET inline void loadDxtBlockPair(const unsigned char *pixels, int width, int height, int channels, int x, int y, DxtBlockPair &pair)
+{
+	const __m256i byteMask = _mm256_set1_epi32(0xFF);
+	__m256i eight[4];
+	if(channels == 4 && x + 8 <= width && y + 4 <= height)
+	{
+		// a row of both blocks of an RGBA image is one load
+		for(int q = 0; q < 4; q++)
+			eight[q] = _mm256_loadu_si256((const __m256i *)(pixels + ((size_t)(y + q) * width + x) * 4));
+	}
+	else
+	{
+		uint32_t rgba[2][16];
+		loadDxtPixels(pixels, width, height, channels, x, y, rgba[0]);
+		loadDxtPixels(pixels, width, height, channels, x + 4, y, rgba[1]);
+		for(int q = 0; q < 4; q++)
+		{
+			eight[q] = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)&rgba[0][q * 4])),
+				_mm_loadu_si128((const __m128i *)&rgba[1][q * 4]), 1);
+		}
+	}
+
+	// the alpha bytes of a row of each block, then the rows of each block in turn
+	const __m256i alphas = _mm256_setr_epi8(3, 7, 11, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		3, 7, 11, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	for(int q = 0; q < 4; q++)
+	{
+		pair.r[q] = _mm256_cvtepi32_ps(_mm256_and_si256(eight[q], byteMask));
+		pair.g[q] = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(eight[q], 8), byteMask));
+		pair.b[q] = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(eight[q], 16), byteMask));
+		__m256i a = _mm256_shuffle_epi8(eight[q], alphas);
+		int left = _mm_cvtsi128_si32(_mm256_castsi256_si128(a)), right = _mm_cvtsi128_si32(_mm256_extracti128_si256(a, 1));
+		memcpy(&pair.a[0][q * 4], &left, sizeof(left));
+		memcpy(&pair.a[1][q * 4], &right, sizeof(right));
+	}
+}
+
+// the end colors of both blocks, dxtEndColors() two at a time
+CPU_FEATURES_AVX2_TARGET inline void dxtEndColorsPair(const DxtBlockPair &pair, int colorMax[2], int colorMin[2])
+{
+	__m256 r = _mm256_setzero_ps(), g = r, b = r, rr = r, gg = r, bb = r, rg = r, rb = r, gb = r;
+	for(int q = 0; q < 4; q++)
+	{
+		r = _mm256_add_ps(r, pair.r[q]);
+		g = _mm256_add_ps(g, pair.g[q]);
+		b = _mm256_add_ps(b, pair.b[q]);
+		rr = _mm256_add_ps(rr, _mm256_mul_ps(pair.r[q], pair.r[q]));
+		gg = _mm256_add_ps(gg, _mm256_mul_ps(pair.g[q], pair.g[q]));
+		bb = _mm256_add_ps(bb, _mm256_mul_ps(pair.b[q], pair.b[q]));
+		rg = _mm256_add_ps(rg, _mm256_mul_ps(pair.r[q], pair.g[q]));
+		rb = _mm256_add_ps(rb, _mm256_mul_ps(pair.r[q], pair.b[q]));
+		gb = _mm256_add_ps(gb, _mm256_mul_ps(pair.g[q], pair.b[q]));
+	}
+	const __m256 zero = _mm256_setzero_ps();
+	float halves[3][8];
+	_mm256_storeu_ps(halves[0], dxtSumsPair(r, g, b, rr));
+	_mm256_storeu_ps(halves[1], dxtSumsPair(gg, bb, rg, rb));
+	_mm256_storeu_ps(halves[2], dxtSumsPair(gb, zero, zero, zero));
+	float point[2][3], direction[2][3], scale[2];
+	for(int k = 0; k < 2; k++)
+	{
+		float sums[12];
+		memcpy(sums, &halves[0][k * 4], 4 * sizeof(float));
+		memcpy(sums + 4, &halves[1][k * 4], 4 * sizeof(float));
+		memcpy(sums + 8, &halves[2][k * 4], 4 * sizeof(float));
+		dxtColorLine(sums, point[k], direction[k], scale[k]);
+	}
+
+	const __m256 dirR = _mm256_setr_ps(direction[0][0], direction[0][0], direction[0][0], direction[0][0],
+		direction[1][0], direction[1][0], direction[1][0], direction[1][0]);
+	const __m256 dirG = _mm256_setr_ps(direction[0][1], direction[0][1], direction[0][1], direction[0][1],
+		direction[1][1], direction[1][1], direction[1][1], direction[1][1]);
+	const __m256 dirB = _mm256_setr_ps(direction[0][2], direction[0][2], direction[0][2], direction[0][2],
+		direction[1][2], direction[1][2], direction[1][2], direction[1][2]);
+	__m256 low = _mm256_set1_ps(3.0e38f), high = _mm256_set1_ps(-3.0e38f);
+	for(int q = 0; q < 4; q++)
+	{
+		__m256 dot = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dirR, pair.r[q]), _mm256_mul_ps(dirG, pair.g[q])), _mm256_mul_ps(dirB, pair.b[q]));
+		low = _mm256_min_ps(low, dot);
+		high = _mm256_max_ps(high, dot);
+	}
+	dxtEndColorsFromDots(point[0], direction[0], scale[0], dxtMin(_mm256_castps256_ps128(low)), dxtMax(_mm256_castps256_ps128(high)),
+		colorMax[0], colorMin[0]);
+	dxtEndColorsFromDots(point[1], direction[1], scale[1], dxtMin(_mm256_extractf128_ps(low, 1)), dxtMax(_mm256_extractf128_ps(high, 1)),
+		colorMax[1], colorMin[1]);
+}
+
+// the color of both blocks, the right one stride bytes after the left one
+CPU_FEATURES_AVX2_TARGET inline void compressDxtColorPair(const DxtBlockPair &pair, unsigned char *out, size_t stride)
+{
+	int colorMax[2], colorMin[2];
+	dxtEndColorsPair(pair, colorMax, colorMin);
+	float line[2][3], offset[2];
+	dxtIndexLine(colorMax[0], colorMin[0], out, line[0], offset[0]);
+	dxtIndexLine(colorMax[1], colorMin[1], out + stride, line[1], offset[1]);
+
+	const __m256 lineR = _mm256_setr_ps(line[0][0], line[0][0], line[0][0], line[0][0], line[1][0], line[1][0], line[1][0], line[1][0]);
+	const __m256 lineG = _mm256_setr_ps(line[0][1], line[0][1], line[0][1], line[0][1], line[1][1], line[1][1], line[1][1], line[1][1]);
+	const __m256 lineB = _mm256_setr_ps(line[0][2], line[0][2], line[0][2], line[0][2], line[1][2], line[1][2], line[1][2], line[1][2]);
+	const __m256 offsets = _mm256_setr_ps(offset[0], offset[0], offset[0], offset[0], offset[1], offset[1], offset[1], offset[1]);
+	const __m256 three = _mm256_set1_ps(3.0f), half = _mm256_set1_ps(0.5f);
+	__m256i steps[4];
+	for(int q = 0; q < 4; q++)
+	{
+		__m256 dot = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(lineR, pair.r[q]), _mm256_mul_ps(lineG, pair.g[q])),
+			_mm256_mul_ps(lineB, pair.b[q])), offsets);
+		steps[q] = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(dot, three), half));
+	}
+	// the packs work within each half, so the low 16 bytes are the left block's steps in order and the high 16 the right one's
+	__m256i step = _mm256_packs_epi16(_mm256_packs_epi32(steps[0], steps[1]), _mm256_packs_epi32(steps[2], steps[3]));
+	uint32_t low = _mm256_movemask_epi8(_mm256_cmpgt_epi8(step, _mm256_set1_epi8(1)));
+	uint32_t high = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpgt_epi8(step, _mm256_setzero_si256()), _mm256_cmpgt_epi8(_mm256_set1_epi8(3), step)));
+	dxtColorIndices(low & 0xFFFF, high & 0xFFFF, out + 4);
+	dxtColorIndices(low >> 16, high >> 16, out + stride + 4);
+}
+
+// the alpha of both blocks, the right one stride bytes after the left one
+CPU_FEATURES_AVX2_TARGET inline void compressDxtAlphaPair(const DxtBlockPair &pair, unsigned char *out, size_t stride)
+{
+	float left = dxtAlphaRange(pair.a[0], out), right = dxtAlphaRange(pair.a[1], out + stride);
+	const __m256 scale = _mm256_setr_ps(left, left, left, left, right, right, right, right);
+	const __m256i low = _mm256_setr_epi32(out[1], out[1], out[1], out[1], out[stride + 1], out[stride + 1], out[stride + 1], out[stride + 1]);
+	int steps[2][16];
+	for(int q = 0; q < 4; q++)
+	{
+		int packed[2];
+		memcpy(&packed[0], &pair.a[0][q * 4], sizeof(int));
+		memcpy(&packed[1], &pair.a[1][q * 4], sizeof(int));
+		__m256i eight = _mm256_cvtepu8_epi32(_mm_unpacklo_epi32(_mm_cvtsi32_si128(packed[0]), _mm_cvtsi32_si128(packed[1])));
+		__m256i value = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(eight, low)), scale));
+		_mm_storeu_si128((__m128i *)&steps[0][q * 4], _mm256_castsi256_si128(value));
+		_mm_storeu_si128((__m128i *)&steps[1][q * 4], _mm256_extracti128_si256(value, 1));
+	}
+	dxtAlphaIndices(steps[0], out + 2);
+	dxtAlphaIndices(steps[1], out + stride + 2);
+}
+
+// compressDxtRows() two blocks at a time, only for processors with AVX2; the last block of an odd row goes alone
+CPU_FEATURES_AVX2_TARGET inline void compressDxtRowsAvx2(const unsigned char *pixels, int width, int height, int channels, bool alpha,
+	unsigned char *blocks, int first, int last)
+{
+	size_t blockBytes = alpha ? 16 : 8;
+	unsigned char *out = blocks + first * dxtSize(width, 1, alpha);
+	DxtBlockPair pair;
+	for(int y = first * 4; y < last * 4 && y < height; y += 4)
+	{
+		int x = 0;
+		for(; x + 4 < width; x += 8)
+		{
+			loadDxtBlockPair(pixels, width, height, channels, x, y, pair);
+			if(alpha)
+			{
+				compressDxtAlphaPair(pair, out, blockBytes);
+				compressDxtColorPair(pair, out + 8, blockBytes);
+			}
+			else
+				compressDxtColorPair(pair, out, blockBytes);
+			out += blockBytes * 2;
+		}
+		if(x < width)
+		{
+			compressDxtBlock(pixels, width, height, channels, alpha, x, y, out);
+			out += blockBytes;
+		}
+	}
+}
+#endif
+#endif
+
+// compress an image of 1 to 4 channels (tightly packed rows) to DXT5 if alpha, DXT1 otherwise,
+// blocks must hold dxtSize() bytes; jobs (if given) share out the rows of blocks
+inline void compressDxt(const unsigned char *pixels, int width, int height, int channels, bool alpha, unsigned char *blocks, JobSystem *jobs = NULL)
+{
+	if(!pixels || width < 1 || height < 1 || channels < 1 || channels > 4)
+		return;
+	int blockRows = (height + 3) / 4;
+	// around a thousand blocks per job
+	size_t grain = 1024 / ((width + 3) / 4) + 1;
+#ifdef DXT_COMPRESSOR_AVX2
+	bool avx2 = cpuHasAvx2();
+#endif
+	auto rows = [&](size_t first, size_t last)
+	{
+#if defined(DXT_COMPRESSOR_AVX2)
+		if(avx2)
+			compressDxtRowsAvx2(pixels, width, height, channels, alpha, blocks, first, last);
+		else
+			compressDxtRows(pixels, width, height, channels, alpha, blocks, first, last);
+#elif defined(DXT_COMPRESSOR_SSE2)
+		compressDxtRows(pixels, width, height, channels, alpha, blocks, first, last);
+#else
+		compressDxtRowsReference(pixels, width, height, channels, alpha, blocks, first, last);
+#endif
+	};
+	if(jobs)
+		jobs->parallelFor(0, blockRows, grain, rows);
+	else
+		rows(0, blockRows);
+}
+
+
+// compress an RGB or RGBA image to DXT5 in YCoCg: Co and Cg in red and green, Y in alpha (which DXT5 keeps more precisely),
+// the same as convert_RGB_to_YCoCg followed by convert_image_to_DXT5; an RGBA image's alpha ends up in blue, which is lossy,
+// and a shader reads the color back as (Y + Co - Cg, Y + Cg, Y - Co - Cg) with Co and Cg less 0.5
+inline void compressDxtYCoCg(const unsigned char *pixels, int width, int height, int channels, unsigned char *blocks, JobSystem *jobs = NULL)
+{
+	if(!pixels || width < 1 || height < 1 || channels < 3 || channels > 4)
+		return;
+	std::vector<unsigned char> rgba((size_t)width * height * 4);
+	for(size_t i = 0, count = (size_t)width * height; i < count; i++)
+	{
+		memcpy(&rgba[i * 4], pixels + i * channels, 3);
+		rgba[i * 4 + 3] = channels == 4 ? pixels[i * 4 + 3] : 255;
+	}
+	convertRgbToYCoCg(&rgba[0], width, height, 4);
+	compressDxt(&rgba[0], width, height, 4, true, blocks, jobs);
+}
+#endif
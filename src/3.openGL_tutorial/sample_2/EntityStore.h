@@ -0,0 +1,127 @@
+// STRUCTURE-OF-ARRAYS STORE OF GAME ENTITIES (CREATURES, TREES)
+// EVERY COMPONENT IS ITS OWN CONTIGUOUS ARRAY INDEXED BY ENTITY, SO A SYSTEM ONLY WALKS THE ARRAYS
+// IT ACTUALLY READS OR WRITES (SEE EntitySystems.h), AND THOUSANDS OF ENTITIES STAY CACHE FRIENDLY
+
+#ifndef ENTITY_STORE_H
+#define ENTITY_STORE_H
+
+#include <glm/glm.hpp>
+
+#include <stddef.h>
+
+#include <vector>
+
+// HOW AN ENTITY IS DRAWN
+enum EntityModel {
+	MODEL_WATER_SHEEP,
+	MODEL_ZOMBIE,
+	MODEL_TREE
+};
+
+class EntityStore
+{
+public:
+	// TRANSFORM: position and facing around the y axis in radians
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+	std::vector<float> heading;
+
+	// TRANSFORM AT THE END OF THE PREVIOUS TICK, RENDERING BLENDS BETWEEN THE TWO
+	std::vector<float> previousX;
+	std::vector<float> previousY;
+	std::vector<float> previousZ;
+	std::vector<float> previousHeading;
+
+	// SPAWN POINT, WHERE respawn() PUTS THE ENTITY BACK
+	std::vector<float> homeX;
+	std::vector<float> homeY;
+	std::vector<float> homeZ;
+	std::vector<float> homeHeading;
+
+	// VELOCITY IN THE GROUND PLANE, IN UNITS PER SECOND
+	std::vector<float> velocityX;
+	std::vector<float> velocityZ;
+
+	// RENDER PART
+	std::vector<unsigned char> model;
+
+	// CHASE AI: speed, how close it gets before stopping, how close it has to be to catch the player
+	// (0 never catches, e.g. a crowd of extra mobs that shouldn't end the game)
+	std::vector<float> chaseSpeed;
+	std::vector<float> stopDistance;
+	std::vector<float> catchDistance;
+
+	// add an entity that stands still, returns its index
+	unsigned int spawn(EntityModel entityModel, const glm::vec3 &position, float facing)
+	{
+		x.push_back(position.x);
+		y.push_back(position.y);
+		z.push_back(position.z);
+		heading.push_back(facing);
+		previousX.push_back(position.x);
+		previousY.push_back(position.y);
+		previousZ.push_back(position.z);
+		previousHeading.push_back(facing);
+		homeX.push_back(position.x);
+		homeY.push_back(position.y);
+		homeZ.push_back(position.z);
+		homeHeading.push_back(facing);
+		velocityX.push_back(0.0f);
+		velocityZ.push_back(0.0f);
+		model.push_back((unsigned char)entityModel);
+		chaseSpeed.push_back(0.0f);
+		stopDistance.push_back(0.0f);
+		catchDistance.push_back(0.0f);
+		return size() - 1;
+	}
+
+	// make an entity chase the player
+	void setChase(unsigned int entity, float speed, float stop, float catchRange)
+	{
+		chaseSpeed[entity] = speed;
+		stopDistance[entity] = stop;
+		catchDistance[entity] = catchRange;
+	}
+
+	size_t size() const
+	{
+		return x.size();
+	}
+
+	glm::vec3 position(unsigned int entity) const
+	{
+		return glm::vec3(x[entity], y[entity], z[entity]);
+	}
+
+	// remember the current transforms as the previous tick's, call before every tick
+	// (and after a teleport, so it isn't drawn sliding there)
+	void keepPrevious()
+	{
+		previousX = x;
+		previousY = y;
+		previousZ = z;
+		previousHeading = heading;
+	}
+
+	// put every entity back on its spawn point, standing still
+	void respawn()
+	{
+		x = homeX;
+		y = homeY;
+		z = homeZ;
+		heading = homeHeading;
+		velocityX.assign(size(), 0.0f);
+		velocityZ.assign(size(), 0.0f);
+	}
+
+	void reserve(size_t count)
+	{
+		std::vector<float> *arrays[] = { &x, &y, &z, &heading, &previousX, &previousY, &previousZ, &previousHeading,
+			&homeX, &homeY, &homeZ, &homeHeading, &velocityX, &velocityZ, &chaseSpeed, &stopDistance, &catchDistance };
+		for(unsigned int i = 0; i < sizeof(arrays) / sizeof(arrays[0]); i++)
+			arrays[i]->reserve(count);
+		model.reserve(count);
+	}
+};
+#endif
@@ -0,0 +1,151 @@
+// THE SYSTEMS THAT RUN OVER THE ENTITY STORE EVERY SIMULATION TICK
+// EACH ONE IS A PLAIN LOOP OVER A FEW COMPONENT ARRAYS: CHASE (AI -> VELOCITY AND HEADING),
+// MOVE (VELOCITY -> POSITION) AND CATCH (POSITION -> HAS THE PLAYER BEEN CAUGHT?)
+// CHASE, THE EXPENSIVE ONE, HANDLES FOUR ENTITIES AT A TIME WITH SSE2
+
+#ifndef ENTITY_SYSTEMS_H
+#define ENTITY_SYSTEMS_H
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <math.h>
+
+#include "EntityStore.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ENTITY_SYSTEMS_SSE2
+#include <emmintrin.h>
+#endif
+
+// PI VALUE
+const float PI = 3.14159;
+
+// STEER ENTITIES [first, end) STRAIGHT AT THE PLAYER, ONE AT A TIME
+// the reference the SSE2 kernel is checked against, and what runs on the entities left over after it
+// heading is the angle around y that turns the models (which face -z) towards the player,
+// velocity is chaseSpeed along the ground towards the player, or 0 once within stopDistance
+inline void chaseReference(EntityStore &entities, size_t first, size_t end, const glm::vec3 &player)
+{
+	for(size_t i = first; i < end; i++)
+	{
+		float dx = player.x - entities.x[i];
+		float dy = player.y - entities.y[i];
+		float dz = player.z - entities.z[i];
+		float planar2 = dx * dx + dz * dz;
+		float distance2 = planar2 + dy * dy;
+		float stop = entities.stopDistance[i];
+
+		float scale = 0.0f;
+		if(distance2 > stop * stop && planar2 > 0.0f)
+			scale = entities.chaseSpeed[i] / sqrtf(planar2);
+		entities.velocityX[i] = dx * scale;
+		entities.velocityZ[i] = dz * scale;
+		entities.heading[i] = atan2f(-dx, -dz);
+	}
+}
+
+#ifdef ENTITY_SYSTEMS_SSE2
+// atan2(y, x) of four lanes, within 2e-5 radians of atan2f
+// atan of the smaller over the larger magnitude is a polynomial on [0, 1] (Abramowitz & Stegun 4.4.49),
+// then the octant is restored from the magnitudes and signs
+inline __m128 chaseAtan2(__m128 y, __m128 x)
+{
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	__m128 ax = _mm_andnot_ps(signMask, x);
+	__m128 ay = _mm_andnot_ps(signMask, y);
+	__m128 larger = _mm_max_ps(_mm_max_ps(ax, ay), _mm_set1_ps(1e-30f));
+	__m128 a = _mm_div_ps(_mm_min_ps(ax, ay), larger);
+	__m128 s = _mm_mul_ps(a, a);
+
+	__m128 r = _mm_set1_ps(0.0208351f);
+	r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-0.0851330f));
+	r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(0.1801410f));
+	r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-0.3302995f));
+	r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(0.9998660f));
+	r = _mm_mul_ps(r, a);
+
+	// steeper than 45 degrees
+	__m128 steep = _mm_cmpgt_ps(ay, ax);
+	r = _mm_or_ps(_mm_and_ps(steep, _mm_sub_ps(_mm_set1_ps(1.57079633f), r)), _mm_andnot_ps(steep, r));
+	// pointing backwards
+	__m128 back = _mm_cmplt_ps(x, _mm_setzero_ps());
+	r = _mm_or_ps(_mm_and_ps(back, _mm_sub_ps(_mm_set1_ps(3.14159265f), r)), _mm_andnot_ps(back, r));
+	// below the x axis
+	return _mm_or_ps(r, _mm_and_ps(signMask, y));
+}
+#endif
+
+// TURN ENTITIES [first, end) TOWARDS THE PLAYER AND SET THEIR VELOCITY, ONLY WHILE chasing IS SET (HORROR MODE)
+// otherwise they face their default direction and stand still
+// four entities per step with SSE2 when the compiler targets it, the rest with chaseReference()
+// separate ranges touch separate entities, so they can run on different threads
+inline void chaseSystem(EntityStore &entities, size_t first, size_t end, const glm::vec3 &player, bool chasing)
+{
+	if(first >= end)
+		return;
+	if(!chasing)
+	{
+		std::fill(entities.heading.begin() + first, entities.heading.begin() + end, PI);
+		std::fill(entities.velocityX.begin() + first, entities.velocityX.begin() + end, 0.0f);
+		std::fill(entities.velocityZ.begin() + first, entities.velocityZ.begin() + end, 0.0f);
+		return;
+	}
+
+	size_t i = first;
+#ifdef ENTITY_SYSTEMS_SSE2
+	const __m128 playerX = _mm_set1_ps(player.x);
+	const __m128 playerY = _mm_set1_ps(player.y);
+	const __m128 playerZ = _mm_set1_ps(player.z);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	for(; i + 4 <= end; i += 4)
+	{
+		__m128 dx = _mm_sub_ps(playerX, _mm_loadu_ps(&entities.x[i]));
+		__m128 dy = _mm_sub_ps(playerY, _mm_loadu_ps(&entities.y[i]));
+		__m128 dz = _mm_sub_ps(playerZ, _mm_loadu_ps(&entities.z[i]));
+		__m128 planar2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz));
+		__m128 distance2 = _mm_add_ps(planar2, _mm_mul_ps(dy, dy));
+		__m128 stop = _mm_loadu_ps(&entities.stopDistance[i]);
+
+		// speed / planar distance, zeroed for entities that stop (or stand right on the player)
+		__m128 move = _mm_and_ps(_mm_cmpgt_ps(distance2, _mm_mul_ps(stop, stop)), _mm_cmpgt_ps(planar2, zero));
+		__m128 scale = _mm_div_ps(_mm_loadu_ps(&entities.chaseSpeed[i]), _mm_sqrt_ps(planar2));
+		scale = _mm_and_ps(move, scale);
+
+		_mm_storeu_ps(&entities.velocityX[i], _mm_mul_ps(dx, scale));
+		_mm_storeu_ps(&entities.velocityZ[i], _mm_mul_ps(dz, scale));
+		_mm_storeu_ps(&entities.heading[i], chaseAtan2(_mm_xor_ps(dx, signMask), _mm_xor_ps(dz, signMask)));
+	}
+#endif
+	chaseReference(entities, i, end, player);
+}
+
+// MOVE ENTITIES [first, end) BY THEIR VELOCITY
+inline void moveSystem(EntityStore &entities, size_t first, size_t end, float dt)
+{
+	if(first >= end)
+		return;
+	float *x = &entities.x[0];
+	float *z = &entities.z[0];
+	const float *velocityX = &entities.velocityX[0];
+	const float *velocityZ = &entities.velocityZ[0];
+	// a branch-free loop over contiguous arrays, the compiler vectorises it
+	for(size_t i = first; i < end; i++)
+	{
+		x[i] += velocityX[i] * dt;
+		z[i] += velocityZ[i] * dt;
+	}
+}
+
+// HAS ANY OF ENTITIES [first, end) CAUGHT THE PLAYER?
+inline bool catchSystem(const EntityStore &entities, size_t first, size_t end, const glm::vec3 &player)
+{
+	for(size_t i = first; i < end; i++)
+	{
+		if(entities.catchDistance[i] > 0.0f && (glm::length(player - entities.position(i))) <= entities.catchDistance[i])
+			return true;
+	}
+	return false;
+}
+#endif
@@ -0,0 +1,56 @@
+// TURNS THE VARIABLE TIME BETWEEN RENDERED FRAMES INTO A WHOLE NUMBER OF FIXED SIMULATION TICKS
+// WHATEVER IS LEFT OVER BECOMES THE BLEND FACTOR BETWEEN THE LAST TWO TICKS FOR RENDERING
+
+#ifndef FIXED_TIMESTEP_H
+#define FIXED_TIMESTEP_H
+
+class FixedTimestep
+{
+public:
+	// step is the length of a tick in seconds, at most maxTicksPerFrame run per frame so a long
+	// stall (loading, breakpoints, window dragging) slows the game down instead of freezing it
+	FixedTimestep(float step, unsigned int maxTicksPerFrame) : step(step), maxTicksPerFrame(maxTicksPerFrame), accumulator(0.0), ticks(0) {}
+
+	// add the time that passed since the last frame
+	void advance(float frameTime)
+	{
+		accumulator += frameTime;
+		if(accumulator > step * maxTicksPerFrame)
+			accumulator = step * maxTicksPerFrame;
+	}
+
+	// consume one tick if enough time has built up, call until it returns false
+	bool tick()
+	{
+		if(accumulator < step)
+			return false;
+		accumulator -= step;
+		ticks++;
+		return true;
+	}
+
+	// how far the leftover time is into the next tick, 0 to 1
+	float alpha() const
+	{
+		return (float)(accumulator / step);
+	}
+
+	// simulated time since the start, in seconds
+	float time() const
+	{
+		return (float)(ticks * (double)step);
+	}
+
+	float stepLength() const
+	{
+		return step;
+	}
+
+private:
+	float step;
+	unsigned int maxTicksPerFrame;
+	// double so the leftover doesn't drift over a long session
+	double accumulator;
+	unsigned long long ticks;
+};
+#endif
@@ -0,0 +1,71 @@
+// PER-FRAME CAMERA AND LIGHT STATE, SHARED BY EVERY SHADER PROGRAM THROUGH ONE std140 UNIFORM BUFFER
+// THE BUFFER IS FILLED ONCE PER FRAME, NO MATTER HOW MANY PROGRAMS READ FROM IT
+
+#ifndef FRAME_DATA_H
+#define FRAME_DATA_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// uniform buffer binding point of the FrameData block
+const unsigned int FRAME_DATA_BINDING = 0;
+
+// mirrors the Light struct inside the FrameData block
+// (std140 lets a float fill the gap after a vec3, so no extra padding is needed between them)
+struct FrameLight
+{
+	glm::vec3 position;
+	float constant;
+	glm::vec3 ambient;
+	float linear;
+	glm::vec3 diffuse;
+	float quadratic;
+	glm::vec3 specular;
+	float padding;
+};
+
+// mirrors the FrameData block declared in lightingVS.vs, lightingFS.fs and lampVS.vs
+struct FrameData
+{
+	glm::mat4 projection;
+	glm::mat4 view;
+	glm::vec3 viewPos;
+	float padding;
+	FrameLight light;
+};
+
+static_assert(sizeof(FrameLight) == 64, "FrameLight must match the std140 layout of Light");
+static_assert(sizeof(FrameData) == 208, "FrameData must match the std140 layout of the FrameData block");
+
+class FrameDataBuffer
+{
+public:
+	unsigned int UBO;
+
+	FrameDataBuffer() : UBO(0) {}
+
+	// allocate the buffer and bind it to FRAME_DATA_BINDING
+	void create()
+	{
+		glGenBuffers(1, &UBO);
+		glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), NULL, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, UBO);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
+	// replace the whole block with this frame's values
+	void upload(const FrameData &data)
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &data);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
+	void release()
+	{
+		glDeleteBuffers(1, &UBO);
+		UBO = 0;
+	}
+};
+#endif
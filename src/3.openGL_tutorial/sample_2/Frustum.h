@@ -0,0 +1,103 @@
+// THE SIX PLANES OF THE VIEW FRUSTUM, TAKEN STRAIGHT FROM A projection * view MATRIX,
+// SO THE SAME CODE WORKS FOR THE PERSPECTIVE AND THE ORTHOGRAPHIC PROJECTION
+// ANYTHING WHOSE BOUNDS LIE ENTIRELY BEHIND ONE OF THE PLANES IS OFF SCREEN AND NEED NOT BE DRAWN
+
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+#include <math.h>
+
+// where a box lies relative to the frustum
+enum FrustumTest {
+	FRUSTUM_OUTSIDE,
+	FRUSTUM_INTERSECTS,
+	FRUSTUM_INSIDE
+};
+
+class Frustum
+{
+public:
+	/*
+		SOURCE(S):
+			Gribb, G. & Hartmann, K. (2001) Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix
+	*/
+	// every plane is a sum or difference of the fourth row of the matrix and one of the others,
+	// normalised so a plane's dot product with a point is the signed distance to it (positive inside)
+	void extract(const glm::mat4 &viewProjection)
+	{
+		// glm stores columns, m[column][row]
+		const glm::mat4 &m = viewProjection;
+		glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+		glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+		glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+		glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+		// left, right, bottom, top, near, far
+		planes[0] = row3 + row0;
+		planes[1] = row3 - row0;
+		planes[2] = row3 + row1;
+		planes[3] = row3 - row1;
+		planes[4] = row3 + row2;
+		planes[5] = row3 - row2;
+		for(unsigned int i = 0; i < 6; i++)
+			planes[i] /= glm::length(glm::vec3(planes[i]));
+	}
+
+	// is any part of the sphere inside?
+	bool containsSphere(const glm::vec3 &center, float radius) const
+	{
+		for(unsigned int i = 0; i < 6; i++)
+		{
+			if(glm::dot(glm::vec3(planes[i]), center) + planes[i].w < -radius)
+				return false;
+		}
+		return true;
+	}
+
+	// is any part of the axis-aligned box inside? extent is half its size along each axis
+	// (a box near a corner of the frustum can be let through, never a visible one rejected)
+	bool containsBox(const glm::vec3 &center, const glm::vec3 &extent) const
+	{
+		for(unsigned int i = 0; i < 6; i++)
+		{
+			glm::vec3 normal(planes[i]);
+			// how far the box reaches towards the plane's inside
+			float reach = extent.x * fabsf(normal.x) + extent.y * fabsf(normal.y) + extent.z * fabsf(normal.z);
+			if(glm::dot(normal, center) + planes[i].w < -reach)
+				return false;
+		}
+		return true;
+	}
+
+	// is the axis-aligned box entirely outside, partly inside or entirely inside?
+	// lets a hierarchy accept or reject everything under a node with one test
+	FrustumTest classifyBox(const glm::vec3 &center, const glm::vec3 &extent) const
+	{
+		FrustumTest result = FRUSTUM_INSIDE;
+		for(unsigned int i = 0; i < 6; i++)
+		{
+			glm::vec3 normal(planes[i]);
+			float reach = extent.x * fabsf(normal.x) + extent.y * fabsf(normal.y) + extent.z * fabsf(normal.z);
+			float distance = glm::dot(normal, center) + planes[i].w;
+			if(distance < -reach)
+				return FRUSTUM_OUTSIDE;
+			if(distance < reach)
+				result = FRUSTUM_INTERSECTS;
+		}
+		return result;
+	}
+
+	// axis-aligned box around the unit cube (-0.5 to 0.5) that model places in the world,
+	// every cube of the game is drawn this way
+	static void cubeBounds(const glm::mat4 &model, glm::vec3 &center, glm::vec3 &extent)
+	{
+		center = glm::vec3(model[3]);
+		extent = 0.5f * (glm::abs(glm::vec3(model[0])) + glm::abs(glm::vec3(model[1])) + glm::abs(glm::vec3(model[2])));
+	}
+
+private:
+	glm::vec4 planes[6];
+};
+#endif
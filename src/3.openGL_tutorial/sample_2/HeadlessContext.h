@@ -0,0 +1,120 @@
+// CREATES AN OPENGL 3.3 CORE CONTEXT WITHOUT A WINDOW (EGL SURFACELESS, E.G. MESA LLVMPIPE)
+// AND AN OFFSCREEN FRAMEBUFFER TO RENDER INTO, USED BY THE BENCHMARK BUILD INSTEAD OF GLFW
+
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+
+#include <glad/glad.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <iostream>
+
+class HeadlessContext
+{
+public:
+	HeadlessContext() : display(EGL_NO_DISPLAY), context(EGL_NO_CONTEXT), FBO(0), colourRBO(0), depthRBO(0) {}
+
+	// create the context and make it current, returns false if EGL can't provide one
+	bool create()
+	{
+		// prefer the surfaceless platform so no display server is needed
+		PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+		if(getPlatformDisplay)
+			display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+		if(display == EGL_NO_DISPLAY)
+			display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+		EGLint major, minor;
+		if(display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+		{
+			std::cout << "Error initialising EGL" << std::endl;
+			return false;
+		}
+
+		// surfaceless configs only advertise pbuffer support, the default (window) would match nothing
+		const EGLint configAttributes[] = {
+			EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_NONE
+		};
+		EGLConfig config;
+		EGLint numConfigs = 0;
+		eglChooseConfig(display, configAttributes, &config, 1, &numConfigs);
+		if(numConfigs == 0)
+		{
+			std::cout << "Error finding an EGL config for desktop OpenGL" << std::endl;
+			return false;
+		}
+
+		eglBindAPI(EGL_OPENGL_API);
+		const EGLint contextAttributes[] = {
+			EGL_CONTEXT_MAJOR_VERSION, 3,
+			EGL_CONTEXT_MINOR_VERSION, 3,
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_NONE
+		};
+		context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+		if(context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+		{
+			std::cout << "Error creating a surfaceless OpenGL 3.3 context" << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	// render into an offscreen colour + depth target of the given size (needs GLAD loaded)
+	void createFramebuffer(unsigned int width, unsigned int height)
+	{
+		glGenRenderbuffers(1, &colourRBO);
+		glBindRenderbuffer(GL_RENDERBUFFER, colourRBO);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+		glGenRenderbuffers(1, &depthRBO);
+		glBindRenderbuffer(GL_RENDERBUFFER, depthRBO);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+		glGenFramebuffers(1, &FBO);
+		glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colourRBO);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+		if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			std::cout << "Error creating the offscreen framebuffer" << std::endl;
+
+		glViewport(0, 0, width, height);
+	}
+
+	// what GLAD loads the OpenGL functions through
+	static void *procAddress(const char *name)
+	{
+		return (void*)eglGetProcAddress(name);
+	}
+
+	void release()
+	{
+		if(FBO)
+		{
+			glDeleteFramebuffers(1, &FBO);
+			glDeleteRenderbuffers(1, &colourRBO);
+			glDeleteRenderbuffers(1, &depthRBO);
+			FBO = colourRBO = depthRBO = 0;
+		}
+		if(display != EGL_NO_DISPLAY)
+		{
+			eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+			if(context != EGL_NO_CONTEXT)
+				eglDestroyContext(display, context);
+			eglTerminate(display);
+		}
+		display = EGL_NO_DISPLAY;
+		context = EGL_NO_CONTEXT;
+	}
+
+private:
+	EGLDisplay display;
+	EGLContext context;
+	unsigned int FBO;
+	unsigned int colourRBO;
+	unsigned int depthRBO;
+};
+#endif
@@ -0,0 +1,170 @@
+// RECORDS THE INPUT OF EVERY FRAME (GAME CLOCK, HELD KEYS, MOUSE MOVEMENT) TO A SMALL BINARY FILE
+// AND PLAYS IT BACK, SO TWO RUNS OF THE GAME GO THROUGH EXACTLY THE SAME SIMULATION
+//
+// FILE LAYOUT (NATIVE BYTE ORDER):
+//   "S2IR", uint32 version
+//   then per frame: float gameTime, uint16 key bits (bit i = InputKey i), float mouseX, float mouseY
+// THERE IS NO FRAME COUNT, A RECORDING CUT SHORT BY A CRASH IS STILL READABLE UP TO ITS LAST FULL FRAME
+
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "InputState.h"
+
+const char INPUT_RECORDING_MAGIC[4] = { 'S', '2', 'I', 'R' };
+const uint32_t INPUT_RECORDING_VERSION = 1;
+
+static_assert(INPUT_KEY_COUNT <= 16, "the key bits of a recorded frame are stored in 16 bits");
+
+// one frame of a recording
+struct RecordedFrame
+{
+	// game clock of the frame, deltaTime is the difference to the previous one
+	float time;
+	InputState input;
+};
+
+class InputRecorder
+{
+public:
+	InputRecorder() : file(NULL) {}
+
+	~InputRecorder()
+	{
+		close();
+	}
+
+	// start a new recording, returns false if the file can't be created
+	bool open(const std::string &path)
+	{
+		close();
+		file = fopen(path.c_str(), "wb");
+		if(!file)
+		{
+			std::cout << "Error creating input recording " << path << std::endl;
+			return false;
+		}
+		fwrite(INPUT_RECORDING_MAGIC, 1, sizeof(INPUT_RECORDING_MAGIC), file);
+		fwrite(&INPUT_RECORDING_VERSION, sizeof(INPUT_RECORDING_VERSION), 1, file);
+		return true;
+	}
+
+	bool isOpen() const
+	{
+		return file != NULL;
+	}
+
+	// append a frame, does nothing when no recording is open
+	void write(float time, const InputState &input)
+	{
+		if(!file)
+			return;
+
+		uint16_t keys = 0;
+		for(unsigned int i = 0; i < INPUT_KEY_COUNT; i++)
+		{
+			if(input.keys[i])
+				keys |= 1 << i;
+		}
+		fwrite(&time, sizeof(time), 1, file);
+		fwrite(&keys, sizeof(keys), 1, file);
+		fwrite(&input.mouseX, sizeof(input.mouseX), 1, file);
+		fwrite(&input.mouseY, sizeof(input.mouseY), 1, file);
+	}
+
+	void close()
+	{
+		if(file)
+			fclose(file);
+		file = NULL;
+	}
+
+private:
+	FILE *file;
+};
+
+class InputReplay
+{
+public:
+	InputReplay() : next(0) {}
+
+	// read a whole recording into memory, returns false if it is missing or not a recording
+	bool load(const std::string &path)
+	{
+		frames.clear();
+		next = 0;
+
+		FILE *file = fopen(path.c_str(), "rb");
+		if(!file)
+		{
+			std::cout << "Error opening input recording " << path << std::endl;
+			return false;
+		}
+
+		char magic[sizeof(INPUT_RECORDING_MAGIC)];
+		uint32_t version = 0;
+		if(fread(magic, 1, sizeof(magic), file) != sizeof(magic) || memcmp(magic, INPUT_RECORDING_MAGIC, sizeof(magic)) != 0 ||
+			fread(&version, sizeof(version), 1, file) != 1 || version != INPUT_RECORDING_VERSION)
+		{
+			std::cout << "Error: " << path << " is not a version " << INPUT_RECORDING_VERSION << " input recording" << std::endl;
+			fclose(file);
+			return false;
+		}
+
+		RecordedFrame frame;
+		uint16_t keys;
+		while(fread(&frame.time, sizeof(frame.time), 1, file) == 1 &&
+			fread(&keys, sizeof(keys), 1, file) == 1 &&
+			fread(&frame.input.mouseX, sizeof(frame.input.mouseX), 1, file) == 1 &&
+			fread(&frame.input.mouseY, sizeof(frame.input.mouseY), 1, file) == 1)
+		{
+			for(unsigned int i = 0; i < INPUT_KEY_COUNT; i++)
+				frame.input.keys[i] = (keys >> i) & 1;
+			frames.push_back(frame);
+		}
+		fclose(file);
+		return true;
+	}
+
+	// is a recording loaded?
+	bool isOpen() const
+	{
+		return !frames.empty();
+	}
+
+	size_t frameCount() const
+	{
+		return frames.size();
+	}
+
+	// every frame has been played back
+	bool finished() const
+	{
+		return next >= frames.size();
+	}
+
+	// game clock of the frame read() returns next
+	float time() const
+	{
+		return frames[next].time;
+	}
+
+	// input of the next frame
+	const InputState &read()
+	{
+		return frames[next++].input;
+	}
+
+private:
+	std::vector<RecordedFrame> frames;
+	size_t next;
+};
+#endif
@@ -0,0 +1,52 @@
+// THE KEYS THE GAME REACTS TO AND THE MOUSE MOVEMENT OF ONE FRAME
+// processInput() READS THIS INSTEAD OF ASKING GLFW, SO THE SAME GAME LOGIC CAN BE DRIVEN BY A SCRIPT
+
+#ifndef INPUT_STATE_H
+#define INPUT_STATE_H
+
+enum InputKey {
+	KEY_ESCAPE,
+	KEY_R,
+	KEY_SPACE,
+	KEY_W,
+	KEY_S,
+	KEY_A,
+	KEY_D,
+	KEY_F,
+	KEY_E,
+	KEY_P,
+	KEY_I,
+	KEY_M,
+	KEY_O,
+	KEY_L,
+	KEY_K,
+	KEY_B,
+	INPUT_KEY_COUNT
+};
+
+struct InputState
+{
+	// is the key held down this frame?
+	bool keys[INPUT_KEY_COUNT];
+	// mouse movement since the last frame, in the units Camera::ProcessMouseMovement expects
+	float mouseX;
+	float mouseY;
+
+	InputState()
+	{
+		clear();
+	}
+
+	void clear()
+	{
+		for(unsigned int i = 0; i < INPUT_KEY_COUNT; i++)
+			keys[i] = false;
+		mouseX = mouseY = 0.0f;
+	}
+
+	bool down(InputKey key) const
+	{
+		return keys[key];
+	}
+};
+#endif
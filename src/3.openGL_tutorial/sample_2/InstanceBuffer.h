@@ -0,0 +1,87 @@
+// STREAMS PER-INSTANCE MODEL AND NORMAL MATRICES TO THE GPU AND FEEDS THEM TO THE SHADERS AS VERTEX ATTRIBUTES
+
+#ifndef INSTANCE_BUFFER_H
+#define INSTANCE_BUFFER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// first vertex attribute location of the per-instance model matrix
+// (a mat4 attribute takes up 4 consecutive locations)
+const unsigned int INSTANCE_MODEL_LOCATION = 3;
+// first vertex attribute location of the per-instance normal matrix (3 locations)
+const unsigned int INSTANCE_NORMAL_LOCATION = 7;
+
+// what the GPU reads for every instance
+struct InstanceData
+{
+	glm::mat4 model;
+	glm::mat3 normal;
+};
+
+class InstanceBuffer
+{
+public:
+	InstanceBuffer() : VBO(0) {}
+
+	// create the buffer (once) and hook it up to the given VAO
+	void attach(unsigned int VAO)
+	{
+		if(VBO == 0)
+			glGenBuffers(1, &VBO);
+
+		glBindVertexArray(VAO);
+		for(unsigned int i = 0; i < 4; i++)
+		{
+			glEnableVertexAttribArray(INSTANCE_MODEL_LOCATION + i);
+			glVertexAttribDivisor(INSTANCE_MODEL_LOCATION + i, 1);
+		}
+		for(unsigned int i = 0; i < 3; i++)
+		{
+			glEnableVertexAttribArray(INSTANCE_NORMAL_LOCATION + i);
+			glVertexAttribDivisor(INSTANCE_NORMAL_LOCATION + i, 1);
+		}
+		pointAttributes(0);
+		glBindVertexArray(0);
+	}
+
+	// replace the buffer contents with this frame's matrices
+	void upload(const std::vector<InstanceData> &instances)
+	{
+		if(instances.empty())
+			return;
+
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		// orphan last frame's storage so the driver does not have to wait on it
+		glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(InstanceData), NULL, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(InstanceData), &instances[0]);
+	}
+
+	// point the instance attributes of the bound VAO at the given instance
+	// (GL 3.3 has no base instance, so the offset is applied to the pointers instead)
+	void pointAttributes(size_t firstInstance)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		size_t offset = firstInstance * sizeof(InstanceData);
+		for(unsigned int i = 0; i < 4; i++)
+		{
+			glVertexAttribPointer(INSTANCE_MODEL_LOCATION + i, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(offset + i * sizeof(glm::vec4)));
+		}
+		for(unsigned int i = 0; i < 3; i++)
+		{
+			glVertexAttribPointer(INSTANCE_NORMAL_LOCATION + i, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(offset + sizeof(glm::mat4) + i * sizeof(glm::vec3)));
+		}
+	}
+
+	void release()
+	{
+		glDeleteBuffers(1, &VBO);
+		VBO = 0;
+	}
+
+private:
+	unsigned int VBO;
+};
+#endif
@@ -0,0 +1,189 @@
+// A SMALL WORK-STEALING JOB SYSTEM: A FIXED POOL OF WORKER THREADS, ONE JOB DEQUE PER THREAD,
+// AND parallelFor() TO SPLIT A RANGE OF ENTITIES INTO JOBS
+// A THREAD TAKES ITS NEWEST JOB FROM THE BACK OF ITS OWN DEQUE, AN IDLE ONE STEALS THE OLDEST FROM THE FRONT OF ANOTHER'S
+// THE THREAD THAT CALLS parallelFor() WORKS ON THE RANGE TOO, SO A SYSTEM WITH 0 WORKERS SIMPLY RUNS IT INLINE
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <stddef.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem
+{
+public:
+	// start workers extra threads, e.g. std::thread::hardware_concurrency() - 1
+	JobSystem(unsigned int workers) : queues(workers + 1), queued(0), stopping(false)
+	{
+		for(unsigned int i = 0; i < workers; i++)
+			threads.push_back(std::thread(&JobSystem::workerLoop, this, i + 1));
+	}
+
+	~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for(size_t i = 0; i < threads.size(); i++)
+			threads[i].join();
+	}
+
+	// workers that give every core of the machine one thread, counting the thread that calls parallelFor()
+	static unsigned int workersPerCore()
+	{
+		unsigned int cores = std::thread::hardware_concurrency();
+		return cores > 1 ? cores - 1 : 0;
+	}
+
+	// threads working on a parallelFor(), the workers plus the calling thread
+	unsigned int threadCount() const
+	{
+		return queues.size();
+	}
+
+	// call body(first, last) over [begin, end) in pieces of at most grain, spread over every thread,
+	// and return once all of them are done
+	template<class Body>
+	void parallelFor(size_t begin, size_t end, size_t grain, const Body &body)
+	{
+		if(begin >= end)
+			return;
+		if(threads.empty() || end - begin <= grain)
+		{
+			body(begin, end);
+			return;
+		}
+
+		size_t pieces = (end - begin + grain - 1) / grain;
+		std::atomic<size_t> remaining(pieces);
+		Job job;
+		job.run = &runBody<Body>;
+		job.body = &body;
+		job.remaining = &remaining;
+
+		// queue every piece on this thread's deque, the workers steal from it
+		// (counted first, so a worker never sees the count drop below what is queued)
+		queued += pieces;
+		Queue &own = queues[queueIndex()];
+		{
+			std::lock_guard<std::mutex> lock(own.mutex);
+			for(size_t first = begin; first < end; first += grain)
+			{
+				job.first = first;
+				job.last = first + grain < end ? first + grain : end;
+				own.jobs.push_back(job);
+			}
+		}
+		{
+			// a worker between checking queued and going to sleep holds this, so the wake-up can't be missed
+			std::lock_guard<std::mutex> lock(sleepMutex);
+		}
+		wake.notify_all();
+
+		// help out until every piece has run, on this range or whatever else is queued
+		while(remaining.load() > 0)
+		{
+			if(!runOne(queueIndex()))
+				std::this_thread::yield();
+		}
+	}
+
+private:
+	struct Job
+	{
+		void (*run)(const void *body, size_t first, size_t last);
+		const void *body;
+		size_t first;
+		size_t last;
+		// pieces of the parallelFor() still to finish
+		std::atomic<size_t> *remaining;
+	};
+
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	template<class Body>
+	static void runBody(const void *body, size_t first, size_t last)
+	{
+		(*(const Body*)body)(first, last);
+	}
+
+	// deque of the calling thread, threads outside the pool share the first one
+	static size_t &queueIndex()
+	{
+		static thread_local size_t index = 0;
+		return index;
+	}
+
+	// run the newest job of the given deque, or steal the oldest one of another, returns false if there was none
+	bool runOne(size_t index)
+	{
+		Job job;
+		bool found = false;
+		{
+			Queue &own = queues[index];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if(!own.jobs.empty())
+			{
+				job = own.jobs.back();
+				own.jobs.pop_back();
+				found = true;
+			}
+		}
+		for(size_t i = 1; !found && i < queues.size(); i++)
+		{
+			Queue &victim = queues[(index + i) % queues.size()];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if(!victim.jobs.empty())
+			{
+				job = victim.jobs.front();
+				victim.jobs.pop_front();
+				found = true;
+			}
+		}
+		if(!found)
+			return false;
+
+		queued--;
+		job.run(job.body, job.first, job.last);
+		job.remaining->fetch_sub(1);
+		return true;
+	}
+
+	void workerLoop(size_t index)
+	{
+		queueIndex() = index;
+		while(true)
+		{
+			if(runOne(index))
+				continue;
+
+			// nothing to do: sleep until a parallelFor() queues more
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			while(queued.load() == 0 && !stopping)
+				wake.wait(lock);
+			if(stopping)
+				return;
+		}
+	}
+
+	std::vector<Queue> queues;
+	std::vector<std::thread> threads;
+	// jobs sitting in any deque, workers sleep while it is 0
+	std::atomic<size_t> queued;
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+	bool stopping;
+};
+#endif
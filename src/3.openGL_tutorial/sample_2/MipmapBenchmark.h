@@ -0,0 +1,120 @@
+// TIMES BUILDING A FULL MIPMAP CHAIN (SEE MipmapChain.h) ON RGB AND RGBA IMAGES OF 64x64 TO 4096x4096 PIXELS AND A FEW ODD SIZES,
+// AGAINST CALLING mipmap_image IN includes/image_helper.c LEVEL AFTER LEVEL, AND CHECKS THAT BOTH MAKE THE SAME PIXELS
+// WRITES MEGABYTES OF SOURCE PIXELS PER SECOND AS JSON
+// ONLY USED BY THE HEADLESS BENCHMARK BUILD (SAMPLE_2_BENCHMARK), RUN WITH "--mipmap"
+
+#ifndef MIPMAP_BENCHMARK_H
+#define MIPMAP_BENCHMARK_H
+
+#include <image_helper.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string.h>
+#include <vector>
+
+#include "Benchmark.h"
+#include "MipmapChain.h"
+
+class MipmapBenchmark
+{
+public:
+	MipmapBenchmark(const BenchmarkOptions &options) : options(options) {}
+
+	bool run()
+	{
+		return writeBenchmarkReport(options, [this](std::ostream &out)
+		{
+			run(out);
+			return true;
+		});
+	}
+
+private:
+	void run(std::ostream &out) const
+	{
+		// the powers of two, then sizes of the game's textures and rows or columns of a single pixel
+		const int sizes[][2] = { { 64, 64 }, { 128, 128 }, { 256, 256 }, { 512, 512 }, { 1024, 1024 }, { 2048, 2048 }, { 4096, 4096 },
+			{ 550, 550 }, { 738, 416 }, { 1600, 1600 }, { 1, 300 }, { 300, 1 } };
+		const unsigned int sizeCount = sizeof(sizes) / sizeof(sizes[0]);
+
+		beginKernelReport(out);
+		out << "\t\"runs\": [\n";
+		double megabytes = 0.0, referenceSeconds = 0.0, chainSeconds = 0.0;
+		bool allIdentical = true;
+		for(unsigned int s = 0; s < sizeCount; s++)
+		{
+			for(int channels = 3; channels <= 4; channels++)
+			{
+				int width = sizes[s][0], height = sizes[s][1];
+				std::vector<unsigned char> pixels((size_t)width * height * channels);
+				unsigned int seed = 12345;
+				for(size_t i = 0; i < pixels.size(); i++)
+				{
+					seed = seed * 1664525u + 1013904223u;
+					pixels[i] = (unsigned char)(seed >> 24);
+				}
+				// about 16 million pixels per size, at least three times
+				unsigned int repeats = std::max(3, (1 << 24) / (width * height));
+
+				std::vector<unsigned char> reference;
+				MipmapChain chain;
+				double referenceMs = 1e30, chainMs = 1e30;
+				for(unsigned int repeat = 0; repeat < repeats; repeat++)
+				{
+					auto start = std::chrono::steady_clock::now();
+					referenceMipmaps(&pixels[0], width, height, channels, reference);
+					auto referenceEnd = std::chrono::steady_clock::now();
+					buildMipmaps(&pixels[0], width, height, channels, chain);
+					auto chainEnd = std::chrono::steady_clock::now();
+
+					referenceMs = std::min(referenceMs, std::chrono::duration<double, std::milli>(referenceEnd - start).count());
+					chainMs = std::min(chainMs, std::chrono::duration<double, std::milli>(chainEnd - referenceEnd).count());
+				}
+				bool identical = reference == chain.pixels;
+
+				double runMegabytes = (double)pixels.size() / (1024.0 * 1024.0);
+				megabytes += runMegabytes;
+				referenceSeconds += referenceMs / 1000.0;
+				chainSeconds += chainMs / 1000.0;
+				allIdentical = allIdentical && identical;
+				out << "\t\t{ \"width\": " << width << ", \"height\": " << height << ", \"channels\": " << channels << ", \"levels\": " << chain.levels.size()
+					<< ", \"referenceMs\": " << referenceMs << ", \"chainMs\": " << chainMs
+					<< ", \"referenceMBps\": " << runMegabytes * 1000.0 / referenceMs << ", \"chainMBps\": " << runMegabytes * 1000.0 / chainMs
+					<< ", \"speedup\": " << referenceMs / chainMs << ", \"identical\": " << (identical ? "true" : "false") << " }"
+					<< (s + 1 < sizeCount || channels < 4 ? "," : "") << "\n";
+			}
+		}
+		out << "\t],\n"
+			<< "\t\"total\": { \"megabytes\": " << megabytes << ", \"referenceMBps\": " << megabytes / referenceSeconds
+			<< ", \"chainMBps\": " << megabytes / chainSeconds << ", \"speedup\": " << referenceSeconds / chainSeconds
+			<< ", \"identical\": " << (allIdentical ? "true" : "false") << " }\n"
+			<< "}" << std::endl;
+	}
+
+	// every level below the image one after the other, the way the texture cache built them before the chain
+	static void referenceMipmaps(const unsigned char *pixels, int width, int height, int channels, std::vector<unsigned char> &levels)
+	{
+		levels.clear();
+		const unsigned char *level = pixels;
+		while(width > 1 || height > 1)
+		{
+			int nextWidth = width > 1 ? width / 2 : 1;
+			int nextHeight = height > 1 ? height / 2 : 1;
+			size_t offset = level == pixels ? 0 : level - &levels[0];
+			size_t start = levels.size();
+			levels.resize(start + (size_t)nextWidth * nextHeight * channels);
+			// resizing may have moved the previous level
+			if(level != pixels)
+				level = &levels[offset];
+			mipmap_image(level, width, height, channels, &levels[start], width > 1 ? 2 : 1, height > 1 ? 2 : 1);
+			level = &levels[start];
+			width = nextWidth;
+			height = nextHeight;
+		}
+	}
+
+	BenchmarkOptions options;
+};
+#endif
@@ -0,0 +1,198 @@
+// MIPMAP CHAINS BUILT ON THE CPU, PIXEL FOR PIXEL THE SAME AS CALLING mipmap_image IN includes/image_helper.c LEVEL AFTER LEVEL
+// (A 2x2 BOX FILTER ROUNDED TO NEAREST, AN ODD LAST ROW OR COLUMN IS DROPPED, THE SAME SIZES AS glGenerateMipmap),
+// BUT FOUR PIXELS AT A TIME WITH SSE2 AND EVERY LEVEL IN ONE PASS: AS SOON AS A PAIR OF ROWS OF A LEVEL IS DONE
+// IT IS FILTERED INTO A ROW OF THE NEXT ONE WHILE IT IS STILL IN THE CACHE, SO THE FULL SIZE IMAGE IS ONLY READ ONCE
+// (SEE MipmapBenchmark.h FOR THE CHECK AGAINST mipmap_image)
+
+#ifndef MIPMAP_CHAIN_H
+#define MIPMAP_CHAIN_H
+
+#include <stddef.h>
+#include <string.h>
+
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIPMAP_CHAIN_SSE2
+#include <emmintrin.h>
+#endif
+
+// the mipmap levels below an image, from half its size down to 1x1
+struct MipmapChain
+{
+	struct Level
+	{
+		int width;
+		int height;
+		// the level's rows are pixels[offset] to pixels[offset + width * height * channels - 1], tightly packed
+		size_t offset;
+	};
+
+	int channels;
+	std::vector<Level> levels;
+	std::vector<unsigned char> pixels;
+
+	MipmapChain() : channels(0) {}
+
+	void clear()
+	{
+		channels = 0;
+		levels.clear();
+		pixels.clear();
+	}
+
+	unsigned char *levelPixels(size_t level)
+	{
+		return &pixels[levels[level].offset];
+	}
+
+	const unsigned char *levelPixels(size_t level) const
+	{
+		return &pixels[levels[level].offset];
+	}
+};
+
+// the output pixels first to the end of a row of the next level, from the rows above and below of a level width pixels wide
+// (the same row twice for a level one pixel high); (a + b + c + d + 2) / 4 is also mipmap_image's rounding of a 2x1 or 1x2 block
+// when every pixel of it is counted twice
+inline void mipmapRowReference(const unsigned char *above, const unsigned char *below, int width, int channels, unsigned char *out, int first)
+{
+	int mipWidth = width > 1 ? width / 2 : 1;
+	int right = width > 1 ? channels : 0;
+	for(int x = first; x < mipWidth; x++)
+	{
+		const unsigned char *a = above + (size_t)x * 2 * channels;
+		const unsigned char *b = below + (size_t)x * 2 * channels;
+		for(int c = 0; c < channels; c++)
+			out[x * channels + c] = (unsigned char)((a[c] + a[c + right] + b[c] + b[c + right] + 2) >> 2);
+	}
+}
+
+#ifdef MIPMAP_CHAIN_SSE2
+// four 2x2 blocks of RGBA pixels, above0/below0 hold the left two blocks and above1/below1 the right two, a pixel per 32 bit lane
+inline __m128i mipmapBlocks(__m128i above0, __m128i above1, __m128i below0, __m128i below1)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i two = _mm_set1_epi16(2);
+	// the pixels of both rows summed per channel in 16 bits, two pixels per register
+	__m128i pixels01 = _mm_add_epi16(_mm_unpacklo_epi8(above0, zero), _mm_unpacklo_epi8(below0, zero));
+	__m128i pixels23 = _mm_add_epi16(_mm_unpackhi_epi8(above0, zero), _mm_unpackhi_epi8(below0, zero));
+	__m128i pixels45 = _mm_add_epi16(_mm_unpacklo_epi8(above1, zero), _mm_unpacklo_epi8(below1, zero));
+	__m128i pixels67 = _mm_add_epi16(_mm_unpackhi_epi8(above1, zero), _mm_unpackhi_epi8(below1, zero));
+	// plus the pixel to the right
+	__m128i blocks01 = _mm_add_epi16(_mm_unpacklo_epi64(pixels01, pixels23), _mm_unpackhi_epi64(pixels01, pixels23));
+	__m128i blocks23 = _mm_add_epi16(_mm_unpacklo_epi64(pixels45, pixels67), _mm_unpackhi_epi64(pixels45, pixels67));
+	blocks01 = _mm_srli_epi16(_mm_add_epi16(blocks01, two), 2);
+	blocks23 = _mm_srli_epi16(_mm_add_epi16(blocks23, two), 2);
+	return _mm_packus_epi16(blocks01, blocks23);
+}
+
+// four RGB pixels from pixel, a pixel per 32 bit lane (the top byte is the next pixel's red, so pixel[12] must be readable)
+inline __m128i mipmapLoadRgb(const unsigned char *pixel)
+{
+	int words[4];
+	memcpy(&words[0], pixel, 4);
+	memcpy(&words[1], pixel + 3, 4);
+	memcpy(&words[2], pixel + 6, 4);
+	memcpy(&words[3], pixel + 9, 4);
+	return _mm_setr_epi32(words[0], words[1], words[2], words[3]);
+}
+
+// a row of the next level of an RGB or RGBA level at least two pixels wide, the pixels left over by the SSE2 loop with the reference
+inline void mipmapRow(const unsigned char *above, const unsigned char *below, int width, int channels, unsigned char *out)
+{
+	int mipWidth = width / 2;
+	int x = 0;
+	if(channels == 4)
+	{
+		for(; x + 4 <= mipWidth; x += 4)
+		{
+			const unsigned char *a = above + x * 8, *b = below + x * 8;
+			__m128i blocks = mipmapBlocks(_mm_loadu_si128((const __m128i *)a), _mm_loadu_si128((const __m128i *)(a + 16)),
+				_mm_loadu_si128((const __m128i *)b), _mm_loadu_si128((const __m128i *)(b + 16)));
+			_mm_storeu_si128((__m128i *)(out + x * 4), blocks);
+		}
+	}
+	else if(channels == 3)
+	{
+		// every load and store of a pixel touches a byte of the next one, so the last block of a row is left to the reference
+		for(; x + 4 < mipWidth; x += 4)
+		{
+			const unsigned char *a = above + x * 6, *b = below + x * 6;
+			__m128i blocks = mipmapBlocks(mipmapLoadRgb(a), mipmapLoadRgb(a + 12), mipmapLoadRgb(b), mipmapLoadRgb(b + 12));
+			// ascending, so each store's fourth byte is overwritten by the next one
+			for(int i = 0; i < 4; i++)
+			{
+				int word = _mm_cvtsi128_si32(blocks);
+				memcpy(out + (x + i) * 3, &word, 4);
+				blocks = _mm_srli_si128(blocks, 4);
+			}
+		}
+	}
+	mipmapRowReference(above, below, width, channels, out, x);
+}
+#else
+inline void mipmapRow(const unsigned char *above, const unsigned char *below, int width, int channels, unsigned char *out)
+{
+	mipmapRowReference(above, below, width, channels, out, 0);
+}
+#endif
+
+// the mipmap levels below an image of 1 to 4 channels (tightly packed rows, as stb_image returns them), false for anything else
+// or a 1x1 image (which has none)
+inline bool buildMipmaps(const unsigned char *pixels, int width, int height, int channels, MipmapChain &chain)
+{
+	chain.clear();
+	if(!pixels || width < 1 || height < 1 || channels < 1 || channels > 4 || (width == 1 && height == 1))
+		return false;
+	chain.channels = channels;
+
+	// the source image is level 0 here, its rows are never written
+	std::vector<MipmapChain::Level> levels;
+	MipmapChain::Level level;
+	level.width = width;
+	level.height = height;
+	level.offset = 0;
+	levels.push_back(level);
+	size_t size = 0;
+	while(level.width > 1 || level.height > 1)
+	{
+		level.width = level.width > 1 ? level.width / 2 : 1;
+		level.height = level.height > 1 ? level.height / 2 : 1;
+		level.offset = size;
+		levels.push_back(level);
+		chain.levels.push_back(level);
+		size += (size_t)level.width * level.height * channels;
+	}
+	chain.pixels.resize(size);
+
+	// the start of row y of a level
+	auto row = [&](size_t l, int y) -> unsigned char *
+	{
+		unsigned char *start = l == 0 ? (unsigned char *)pixels : chain.levelPixels(l - 1);
+		return start + (size_t)y * levels[l].width * channels;
+	};
+	for(int y = 0; y < levels[1].height; y++)
+	{
+		// the level a row was just written to and the row
+		size_t l = 0;
+		int written = height > 1 ? y * 2 + 1 : 0;
+		while(l + 1 < levels.size())
+		{
+			const MipmapChain::Level &from = levels[l];
+			int above = from.height > 1 ? written - 1 : written;
+			// an odd row of a level taller than one pixel completes a pair, an even one waits for the next
+			if(from.height > 1 && (written & 1) == 0)
+				break;
+			int next = from.height > 1 ? written / 2 : written;
+			if(from.width > 1 && (channels == 3 || channels == 4))
+				mipmapRow(row(l, above), row(l, written), from.width, channels, row(l + 1, next));
+			else
+				mipmapRowReference(row(l, above), row(l, written), from.width, channels, row(l + 1, next), 0);
+			l++;
+			written = next;
+		}
+	}
+	return true;
+}
+#endif
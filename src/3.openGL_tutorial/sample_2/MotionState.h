@@ -0,0 +1,39 @@
+// WHERE THE PLAYER, THE LAMP AND SVEN ARE AT THE END OF A SIMULATION TICK (THE CREATURES KEEP THEIR
+// PREVIOUS TRANSFORMS IN THE ENTITY STORE INSTEAD), THE RENDERER DRAWS A BLEND OF THE LAST TWO TICKS, SO MOTION STAYS SMOOTH AT ANY FRAME RATE
+
+#ifndef MOTION_STATE_H
+#define MOTION_STATE_H
+
+#include <glm/glm.hpp>
+
+#include <math.h>
+
+struct MotionState
+{
+	glm::vec3 cameraPosition;
+	glm::vec3 lightPosition;
+	glm::vec3 svenPosition;
+};
+
+// blend two angles along the shorter way around the circle
+inline float blendAngle(float from, float to, float alpha)
+{
+	const float TWO_PI = 6.28318531f;
+	float difference = fmodf(to - from, TWO_PI);
+	if(difference > TWO_PI / 2)
+		difference -= TWO_PI;
+	else if(difference < -TWO_PI / 2)
+		difference += TWO_PI;
+	return from + difference * alpha;
+}
+
+// alpha 0 gives previous, 1 gives current
+inline MotionState blendMotion(const MotionState &previous, const MotionState &current, float alpha)
+{
+	MotionState motion;
+	motion.cameraPosition = glm::mix(previous.cameraPosition, current.cameraPosition, alpha);
+	motion.lightPosition = glm::mix(previous.lightPosition, current.lightPosition, alpha);
+	motion.svenPosition = glm::mix(previous.svenPosition, current.svenPosition, alpha);
+	return motion;
+}
+#endif
@@ -0,0 +1,140 @@
+// TIMES THE NORMAL MATRIX FUNCTIONS (SEE NormalMatrix.h) ON 100 000 RANDOM TRANSLATE * ROTATE * SCALE MODEL MATRICES:
+// glm::inverseTranspose AS THE REFERENCE, normalMatrix() ONE AT A TIME, THE normalMatrices() BATCH (SSE2 WHEN THE COMPILER TARGETS IT)
+// AND THE rotateScaleNormalMatrix() FAST PATH, AND CHECKS EVERY RESULT AGAINST THE REFERENCE WITHIN A TOLERANCE
+// WRITES MATRICES PER SECOND AND THE LARGEST ERRORS AS JSON
+// ONLY USED BY THE HEADLESS BENCHMARK BUILD (SAMPLE_2_BENCHMARK), RUN WITH "--normals"
+
+#ifndef NORMAL_BENCHMARK_H
+#define NORMAL_BENCHMARK_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <math.h>
+#include <vector>
+
+#include "Benchmark.h"
+#include "NormalMatrix.h"
+
+class NormalBenchmark
+{
+public:
+	NormalBenchmark(const BenchmarkOptions &options) : options(options) {}
+
+	bool run()
+	{
+		return writeBenchmarkReport(options, [this](std::ostream &out)
+		{
+			run(out);
+			return true;
+		});
+	}
+
+private:
+	enum Method
+	{
+		INVERSE_TRANSPOSE,
+		SCALAR,
+		BATCH,
+		FAST_PATH
+	};
+
+	void run(std::ostream &out) const
+	{
+		const unsigned int count = 100000;
+		const unsigned int repeats = 10;
+		// largest difference to the reference allowed, relative to the largest element of the column it is in
+		const float tolerance = 1e-4f;
+		const char *names[] = { "inverseTranspose", "scalar", "batch", "fastPath" };
+
+		std::vector<glm::mat4> models = randomModels(count);
+		std::vector<glm::mat3> reference(count), normals(count);
+		compute(INVERSE_TRANSPOSE, models, reference);
+
+		beginKernelReport(out);
+		out << "\t\"matrices\": " << count << ",\n"
+			<< "\t\"tolerance\": " << tolerance << ",\n"
+			<< "\t\"methods\": [\n";
+		bool allWithin = true;
+		writeSpeedups(out, "method", "matricesPerSecond", names, FAST_PATH + 1, count, [&](int method)
+		{
+			return bestMilliseconds(repeats, [&]() { compute((Method)method, models, normals); });
+		}, [&](std::ostream &line, int)
+		{
+			float error = largestError(reference, normals);
+			bool within = error <= tolerance;
+			allWithin = allWithin && within;
+			line << ", \"maxRelativeError\": " << error << ", \"withinTolerance\": " << (within ? "true" : "false");
+		});
+		out << "\t],\n"
+			<< "\t\"withinTolerance\": " << (allWithin ? "true" : "false") << "\n"
+			<< "}" << std::endl;
+	}
+
+	static void compute(Method method, const std::vector<glm::mat4> &models, std::vector<glm::mat3> &normals)
+	{
+		size_t count = models.size();
+		if(method == BATCH)
+		{
+			normalMatrices(&models[0], &normals[0], count);
+			return;
+		}
+		for(size_t i = 0; i < count; i++)
+		{
+			if(method == INVERSE_TRANSPOSE)
+				normals[i] = glm::inverseTranspose(glm::mat3(models[i]));
+			else if(method == SCALAR)
+				normals[i] = normalMatrix(models[i]);
+			else
+				normals[i] = rotateScaleNormalMatrix(models[i]);
+		}
+	}
+
+	// the largest difference of any element, relative to the largest element of its column in the reference
+	static float largestError(const std::vector<glm::mat3> &reference, const std::vector<glm::mat3> &normals)
+	{
+		float largest = 0.0f;
+		for(size_t i = 0; i < reference.size(); i++)
+		{
+			for(int c = 0; c < 3; c++)
+			{
+				float scale = std::max(fabsf(reference[i][c][0]), std::max(fabsf(reference[i][c][1]), fabsf(reference[i][c][2])));
+				for(int r = 0; r < 3; r++)
+					largest = std::max(largest, fabsf(normals[i][c][r] - reference[i][c][r]) / scale);
+			}
+		}
+		return largest;
+	}
+
+	// translate * rotate * scale with a random axis and angle and a scale of 0.1 to 10 on each axis, the same every run
+	static std::vector<glm::mat4> randomModels(unsigned int count)
+	{
+		std::vector<glm::mat4> models(count);
+		unsigned int seed = 12345;
+		for(unsigned int i = 0; i < count; i++)
+		{
+			float values[10];
+			for(int v = 0; v < 10; v++)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				values[v] = (seed >> 8) / 16777216.0f;
+			}
+			glm::vec3 position(values[0] * 40.0f - 20.0f, values[1] * 40.0f - 20.0f, values[2] * 40.0f - 20.0f);
+			glm::vec3 axis(values[3] * 2.0f - 1.0f, values[4] * 2.0f - 1.0f, values[5] * 2.0f - 1.0f);
+			if(glm::dot(axis, axis) < 1e-4f)
+				axis = glm::vec3(0.0f, 1.0f, 0.0f);
+			glm::vec3 scale(powf(10.0f, values[7] * 2.0f - 1.0f), powf(10.0f, values[8] * 2.0f - 1.0f), powf(10.0f, values[9] * 2.0f - 1.0f));
+
+			glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+			model = glm::rotate(model, values[6] * 6.2831853f, glm::normalize(axis));
+			models[i] = glm::scale(model, scale);
+		}
+		return models;
+	}
+
+	BenchmarkOptions options;
+};
+#endif
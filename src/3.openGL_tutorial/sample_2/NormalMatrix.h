@@ -0,0 +1,91 @@
+// COMPUTES THE NORMAL MATRIX (INVERSE TRANSPOSE OF THE UPPER 3x3 OF A MODEL MATRIX) ON THE CPU,
+// ONE AT A TIME FOR DYNAMIC OBJECTS OR IN BATCHES FOR THE BAKED STATIC SCENE
+
+#ifndef NORMAL_MATRIX_H
+#define NORMAL_MATRIX_H
+
+#include <glm/glm.hpp>
+
+#include <stddef.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NORMAL_MATRIX_SSE2
+#include <emmintrin.h>
+#endif
+
+// normal matrix of any invertible model matrix
+// the inverse transpose of a matrix with columns a, b, c is (b x c, c x a, a x b) / det,
+// so no general inverse is needed
+inline glm::mat3 normalMatrix(const glm::mat4 &model)
+{
+	glm::mat3 m(model);
+	glm::vec3 c0 = glm::cross(m[1], m[2]);
+	glm::vec3 c1 = glm::cross(m[2], m[0]);
+	glm::vec3 c2 = glm::cross(m[0], m[1]);
+	float invDet = 1.0f / glm::dot(m[0], c0);
+	return glm::mat3(c0 * invDet, c1 * invDet, c2 * invDet);
+}
+
+// fast path for a model matrix built as translate * rotate * scale, which is how every object
+// in the game is placed. its columns are at right angles to each other, so the inverse transpose
+// is the matrix itself with each column divided by its squared length
+// (a uniform scale or a pure rotation are special cases of this)
+inline glm::mat3 rotateScaleNormalMatrix(const glm::mat4 &model)
+{
+	glm::vec3 x(model[0]);
+	glm::vec3 y(model[1]);
+	glm::vec3 z(model[2]);
+	return glm::mat3(x * (1.0f / glm::dot(x, x)), y * (1.0f / glm::dot(y, y)), z * (1.0f / glm::dot(z, z)));
+}
+
+#ifdef NORMAL_MATRIX_SSE2
+// cross product of the xyz lanes, w comes out as 0
+inline __m128 normalMatrixCross(__m128 a, __m128 b)
+{
+	__m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+	return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+#endif
+
+// normal matrices of count model matrices, laid out contiguously
+// same result as normalMatrix(), computed with SSE2 when the compiler targets it
+inline void normalMatrices(const glm::mat4 *models, glm::mat3 *normals, size_t count)
+{
+#ifdef NORMAL_MATRIX_SSE2
+	for(size_t i = 0; i < count; i++)
+	{
+		const float *src = &models[i][0][0];
+		float *dst = &normals[i][0][0];
+
+		__m128 m0 = _mm_loadu_ps(src);
+		__m128 m1 = _mm_loadu_ps(src + 4);
+		__m128 m2 = _mm_loadu_ps(src + 8);
+
+		__m128 c0 = normalMatrixCross(m1, m2);
+		__m128 c1 = normalMatrixCross(m2, m0);
+		__m128 c2 = normalMatrixCross(m0, m1);
+
+		// determinant = m0 . c0, summed across the lanes (w of c0 is 0)
+		__m128 d = _mm_mul_ps(m0, c0);
+		d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)));
+		d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(1, 0, 3, 2)));
+		__m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), d);
+
+		c0 = _mm_mul_ps(c0, invDet);
+		c1 = _mm_mul_ps(c1, invDet);
+		c2 = _mm_mul_ps(c2, invDet);
+
+		// a mat3 is 9 packed floats, each 4-wide store's spare lane is overwritten by the next column
+		_mm_storeu_ps(dst, c0);
+		_mm_storeu_ps(dst + 3, c1);
+		_mm_storel_pi((__m64*)(dst + 6), c2);
+		_mm_store_ss(dst + 8, _mm_shuffle_ps(c2, c2, _MM_SHUFFLE(2, 2, 2, 2)));
+	}
+#else
+	for(size_t i = 0; i < count; i++)
+		normals[i] = normalMatrix(models[i]);
+#endif
+}
+#endif
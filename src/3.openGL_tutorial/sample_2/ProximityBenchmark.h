@@ -0,0 +1,153 @@
+// TIMES THE PROXIMITY CHECKS ON 10 000 ENTITIES: THE CATCH AND PICKUP QUERIES THROUGH THE SPATIAL HASH AGAINST
+// LOOKING AT EVERY ENTITY, AND KEEPING THE HASH UP TO DATE AFTER A TICK AGAINST BUILDING IT AGAIN
+// CHECKS THAT BOTH WAYS FIND THE SAME ENTITIES, WRITES THE TIMES AS JSON
+// ONLY USED BY THE HEADLESS BENCHMARK BUILD (SAMPLE_2_BENCHMARK), RUN WITH "--proximity"
+
+#ifndef PROXIMITY_BENCHMARK_H
+#define PROXIMITY_BENCHMARK_H
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "Benchmark.h"
+#include "ChaseBenchmark.h"
+#include "EntityStore.h"
+#include "EntitySystems.h"
+#include "SpatialHash.h"
+#include "World.h"
+
+class ProximityBenchmark
+{
+public:
+	ProximityBenchmark(const BenchmarkOptions &options) : options(options) {}
+
+	bool run()
+	{
+		return writeBenchmarkReport(options, [this](std::ostream &out)
+		{
+			run(out);
+			return true;
+		});
+	}
+
+private:
+	void run(std::ostream &out) const
+	{
+		const unsigned int entities = 10000;
+		const unsigned int queries = 1000;
+		// the distances the game asks about: catching the player and picking something up
+		const float catchDistance = 0.5f;
+		const float pickupDistance = 1.2f;
+
+		EntityStore mobs;
+		ChaseBenchmark::spawnMobs(mobs, entities);
+		for(unsigned int i = 0; i < entities; i++)
+			mobs.setChase(i, 0.25f, 0.5f, catchDistance);
+		SpatialHash grid(1.0f, World::GRID_BUCKETS);
+		for(unsigned int i = 0; i < entities; i++)
+			grid.add(mobs.position(i));
+
+		// places to ask about, spread over the map the same way every run
+		std::vector<glm::vec3> points;
+		unsigned int seed = 54321;
+		for(unsigned int i = 0; i < queries; i++)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			float x = ((seed >> 8) / 16777216.0f) * 20.0f - 10.0f;
+			seed = seed * 1664525u + 1013904223u;
+			float z = ((seed >> 8) / 16777216.0f) * 20.0f - 10.0f;
+			points.push_back(glm::vec3(x, 0.6f, z));
+		}
+
+		// CATCH: is any entity close enough to catch a player standing here?
+		unsigned int bruteCaught = 0, gridCaught = 0;
+		double bruteCatchMs = 1e30, gridCatchMs = 1e30;
+		for(unsigned int repeat = 0; repeat < 5; repeat++)
+		{
+			bruteCaught = gridCaught = 0;
+			auto start = std::chrono::steady_clock::now();
+			for(unsigned int q = 0; q < queries; q++)
+				bruteCaught += catchSystem(mobs, 0, mobs.size(), points[q]);
+			auto middle = std::chrono::steady_clock::now();
+			for(unsigned int q = 0; q < queries; q++)
+			{
+				gridCaught += grid.query(points[q], catchDistance, [&](unsigned int mob, float distance)
+				{
+					return distance <= mobs.catchDistance[mob];
+				});
+			}
+			auto end = std::chrono::steady_clock::now();
+			bruteCatchMs = std::min(bruteCatchMs, std::chrono::duration<double, std::milli>(middle - start).count() / queries);
+			gridCatchMs = std::min(gridCatchMs, std::chrono::duration<double, std::milli>(end - middle).count() / queries);
+		}
+
+		// PICKUP: every entity within reach of a player standing here
+		unsigned long long bruteFound = 0, gridFound = 0;
+		double brutePickupMs = 1e30, gridPickupMs = 1e30;
+		for(unsigned int repeat = 0; repeat < 5; repeat++)
+		{
+			bruteFound = gridFound = 0;
+			auto start = std::chrono::steady_clock::now();
+			for(unsigned int q = 0; q < queries; q++)
+			{
+				for(unsigned int i = 0; i < entities; i++)
+				{
+					if(glm::length(points[q] - mobs.position(i)) <= pickupDistance)
+						bruteFound++;
+				}
+			}
+			auto middle = std::chrono::steady_clock::now();
+			for(unsigned int q = 0; q < queries; q++)
+			{
+				grid.query(points[q], pickupDistance, [&](unsigned int, float)
+				{
+					gridFound++;
+					return false;
+				});
+			}
+			auto end = std::chrono::steady_clock::now();
+			brutePickupMs = std::min(brutePickupMs, std::chrono::duration<double, std::milli>(middle - start).count() / queries);
+			gridPickupMs = std::min(gridPickupMs, std::chrono::duration<double, std::milli>(end - middle).count() / queries);
+		}
+
+		// UPDATE: one tick of chasing moves every entity a little, then the grid has to follow
+		const unsigned int ticks = 100;
+		const glm::vec3 player(1.5f, 0.6f, -2.0f);
+		double incrementalMs = 0.0, rebuildMs = 0.0;
+		for(unsigned int n = 0; n < ticks; n++)
+		{
+			chaseSystem(mobs, 0, mobs.size(), player, true);
+			moveSystem(mobs, 0, mobs.size(), 1.0f / 60.0f);
+
+			auto start = std::chrono::steady_clock::now();
+			for(unsigned int i = 0; i < entities; i++)
+				grid.move(i, mobs.position(i));
+			auto middle = std::chrono::steady_clock::now();
+			SpatialHash rebuilt(1.0f, World::GRID_BUCKETS);
+			for(unsigned int i = 0; i < entities; i++)
+				rebuilt.add(mobs.position(i));
+			auto end = std::chrono::steady_clock::now();
+			incrementalMs += std::chrono::duration<double, std::milli>(middle - start).count();
+			rebuildMs += std::chrono::duration<double, std::milli>(end - middle).count();
+		}
+
+		out << "{\n"
+			<< "\t\"entities\": " << entities << ",\n"
+			<< "\t\"queries\": " << queries << ",\n"
+			<< "\t\"catch\": { \"bruteForceMs\": " << bruteCatchMs << ", \"gridMs\": " << gridCatchMs
+				<< ", \"speedup\": " << bruteCatchMs / gridCatchMs << ", \"caught\": " << bruteCaught
+				<< ", \"sameAnswers\": " << (bruteCaught == gridCaught ? "true" : "false") << " },\n"
+			<< "\t\"pickup\": { \"bruteForceMs\": " << brutePickupMs << ", \"gridMs\": " << gridPickupMs
+				<< ", \"speedup\": " << brutePickupMs / gridPickupMs << ", \"found\": " << bruteFound
+				<< ", \"sameAnswers\": " << (bruteFound == gridFound ? "true" : "false") << " },\n"
+			<< "\t\"update\": { \"incrementalMs\": " << incrementalMs / ticks << ", \"rebuildMs\": " << rebuildMs / ticks << " }\n"
+			<< "}" << std::endl;
+	}
+
+	BenchmarkOptions options;
+};
+#endif
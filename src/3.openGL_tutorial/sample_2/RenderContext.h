@@ -0,0 +1,63 @@
+// BUNDLES THE SHADER PROGRAMS, VERTEX ARRAYS AND TEXTURES NEEDED TO DRAW THE WORLD,
+// SO THE DRAW HELPERS IN "Source.cpp" CAN TAKE ONE REFERENCE INSTEAD OF LONG PARAMETER LISTS
+
+#ifndef RENDER_CONTEXT_H
+#define RENDER_CONTEXT_H
+
+#include "RenderQueue.h"
+#include "RenderState.h"
+
+// EVERY TEXTURE LOADED BY main(), THE *2 VARIANTS ARE USED ONCE THE GAME TURNS INTO HORROR MODE
+struct WorldTextures
+{
+	unsigned int handle;
+	unsigned int sky;
+	unsigned int sky2;
+	unsigned int dirt;
+	unsigned int dirt2;
+	unsigned int svenBody;
+	unsigned int svenHead;
+	unsigned int waterSheepBody;
+	unsigned int waterSheepHead;
+	unsigned int waterSheepHead2;
+	unsigned int wood;
+	unsigned int wood2;
+	unsigned int leaf;
+	unsigned int leaf2;
+	unsigned int zombieBody;
+	unsigned int zombieHead;
+	unsigned int zombieLeg;
+	unsigned int podzol;
+	unsigned int gameOver;
+	unsigned int gameWin;
+	unsigned int structure;
+	unsigned int portal;
+};
+
+class RenderContext
+{
+public:
+	// cube VAO used by the world shader, and the position-only one used by the lamp shader
+	unsigned int VAO;
+	unsigned int lightVAO;
+	WorldTextures textures;
+	// every cube of the frame is submitted here, sorted and drawn at the end of the frame
+	RenderQueue &queue;
+	// filters redundant binds between draws
+	RenderState &state;
+	// handles of the two shaders inside the queue, the shaders themselves are only needed to register them
+	unsigned int lightingProgram;
+	unsigned int lampProgram;
+
+	RenderContext(const Shader &lightingShader, const Shader &lampShader, unsigned int VAO, unsigned int lightVAO, const WorldTextures &textures, RenderQueue &queue, RenderState &state) :
+		VAO(VAO),
+		lightVAO(lightVAO),
+		textures(textures),
+		queue(queue),
+		state(state)
+	{
+		lightingProgram = queue.addProgram(lightingShader, true);
+		lampProgram = queue.addProgram(lampShader, false);
+	}
+};
+#endif
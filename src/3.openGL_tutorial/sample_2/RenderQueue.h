@@ -0,0 +1,343 @@
+// COLLECTS EVERY CUBE DRAWN DURING A FRAME, SORTS THEM BY (SHADER, VAO, TEXTURES, DEPTH)
+// AND SUBMITS THEM SO EACH PIECE OF STATE IS ONLY BOUND ONCE PER FRAME
+// CUBES OUTSIDE THE VIEW FRUSTUM GIVEN TO begin() ARE DROPPED AS THEY ARE SUBMITTED
+// BAKED MESHES (SEE StaticBatch.h) GO THROUGH THE SAME SORT, EACH DRAWN WITH ONE INDEXED DRAW CALL
+
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <stdint.h>
+#include <string.h>
+
+#include "Shader.h"
+#include "RenderState.h"
+#include "InstanceBuffer.h"
+#include "Frustum.h"
+
+class RenderQueue
+{
+public:
+	// per-flush numbers for the debug log
+	struct Stats
+	{
+		// cubes drawn, counting every cube of a baked mesh
+		unsigned int items;
+		// runs of cubes sharing shader, VAO and textures
+		unsigned int batches;
+		// cubes dropped by submit() for being off screen
+		unsigned int culled;
+		// whole objects skipped after visible() said they were off screen, their cubes were never submitted
+		unsigned int culledObjects;
+	};
+
+	RenderQueue() : frustum(NULL), culled(0), culledObjects(0)
+	{
+		stats.items = stats.batches = stats.culled = stats.culledObjects = 0;
+	}
+
+	// register a shader program, returns the handle to pass to submit()
+	// untextured programs skip the texture binds entirely
+	unsigned int addProgram(const Shader &shader, bool textured)
+	{
+		Program program;
+		program.shader = &shader;
+		program.textured = textured;
+		program.modelLoc = shader.getUniformLocation("model");
+		program.normalLoc = shader.getUniformLocation("normalMatrix");
+		program.instancedLoc = shader.getUniformLocation("instanced");
+		programs.push_back(program);
+		return programs.size() - 1;
+	}
+
+	// share the per-instance buffer with a VAO drawn through this queue
+	void attach(unsigned int VAO)
+	{
+		instances.attach(VAO);
+	}
+
+	// start a new frame, depth is measured from the given camera position
+	// cubes outside frustum are culled, NULL draws everything (the frustum must outlive the frame)
+	void begin(const glm::vec3 &viewPosition, const Frustum *frustum)
+	{
+		items.clear();
+		keys.clear();
+		viewPos = viewPosition;
+		this->frustum = frustum;
+		culled = culledObjects = 0;
+	}
+
+	// count cubes the caller found off screen itself
+	void addCulled(unsigned int cubes)
+	{
+		culled += cubes;
+	}
+
+	// is an object bounded by this sphere on screen? lets the caller skip building the cubes of one that isn't
+	bool visible(const glm::vec3 &center, float radius)
+	{
+		if(!frustum || frustum->containsSphere(center, radius))
+			return true;
+		culledObjects++;
+		return false;
+	}
+
+	// queue a cube, normal is the inverse transpose of the model matrix's upper 3x3
+	void submit(unsigned int program, unsigned int VAO, unsigned int diffuseTex, unsigned int specularTex, const glm::mat4 &model, const glm::mat3 &normal)
+	{
+		if(frustum)
+		{
+			glm::vec3 center, extent;
+			Frustum::cubeBounds(model, center, extent);
+			if(!frustum->containsBox(center, extent))
+			{
+				culled++;
+				return;
+			}
+		}
+		submitVisible(program, VAO, diffuseTex, specularTex, model, normal);
+	}
+
+	// queue a cube already known to be on screen (e.g. found by a hierarchy query), skipping the frustum test
+	void submitVisible(unsigned int program, unsigned int VAO, unsigned int diffuseTex, unsigned int specularTex, const glm::mat4 &model, const glm::mat3 &normal)
+	{
+		Item item;
+		item.program = program;
+		item.VAO = VAO;
+		item.diffuseTex = diffuseTex;
+		item.specularTex = specularTex;
+		item.instance.model = model;
+		item.instance.normal = normal;
+		item.firstIndex = item.indexCount = 0;
+		push(item, glm::vec3(model[3]));
+	}
+
+	// queue indices firstIndex to firstIndex + indexCount - 1 of a VAO's element buffer, whole cubes of 36 indices each,
+	// the caller culls it; center is where its depth is measured from, VAO must not be used for single cubes
+	void submitMesh(unsigned int program, unsigned int VAO, unsigned int diffuseTex, unsigned int specularTex, const glm::mat4 &model, const glm::mat3 &normal,
+		unsigned int firstIndex, unsigned int indexCount, const glm::vec3 &center)
+	{
+		Item item;
+		item.program = program;
+		item.VAO = VAO;
+		item.diffuseTex = diffuseTex;
+		item.specularTex = specularTex;
+		item.instance.model = model;
+		item.instance.normal = normal;
+		item.firstIndex = firstIndex;
+		item.indexCount = indexCount;
+		push(item, center);
+	}
+
+	// sort and draw everything submitted since begin()
+	void flush(RenderState &state, bool instanced)
+	{
+		stats.items = 0;
+		for(size_t i = 0; i < items.size(); i++)
+			stats.items += items[i].indexCount > 0 ? items[i].indexCount / 36 : 1;
+		stats.batches = 0;
+		stats.culled = culled;
+		stats.culledObjects = culledObjects;
+		if(items.empty())
+			return;
+
+		sortKeys();
+
+		for(size_t i = 0; i < programs.size(); i++)
+		{
+			state.useProgram(programs[i].shader->ID);
+			programs[i].shader->setBool(programs[i].instancedLoc, instanced);
+		}
+
+		if(instanced)
+		{
+			// one upload for the whole frame, each run then points into its own slice
+			sorted.clear();
+			for(size_t i = 0; i < keys.size(); i++)
+				sorted.push_back(items[keys[i].item].instance);
+			instances.upload(sorted);
+		}
+
+		size_t first = 0;
+		while(first < keys.size())
+		{
+			// the top 32 bits hold everything but the depth
+			size_t last = first + 1;
+			while(last < keys.size() && (keys[last].value >> 32) == (keys[first].value >> 32))
+				last++;
+
+			const Item &item = items[keys[first].item];
+			const Program &program = programs[item.program];
+			state.useProgram(program.shader->ID);
+			state.bindVertexArray(item.VAO);
+			if(program.textured)
+			{
+				state.bindTexture(0, item.diffuseTex);
+				state.bindTexture(1, item.specularTex);
+			}
+
+			if(item.indexCount > 0)
+			{
+				// a baked mesh is already most of a frame's cubes in one draw, it is never instanced
+				if(instanced)
+					program.shader->setBool(program.instancedLoc, false);
+				for(size_t i = first; i < last; i++)
+				{
+					const Item &mesh = items[keys[i].item];
+					program.shader->setMat4(program.modelLoc, mesh.instance.model);
+					program.shader->setMat3(program.normalLoc, mesh.instance.normal);
+					state.drawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, (void*)(mesh.firstIndex * sizeof(unsigned int)));
+				}
+				if(instanced)
+					program.shader->setBool(program.instancedLoc, true);
+			}
+			else if(instanced)
+			{
+				instances.pointAttributes(first);
+				state.drawArraysInstanced(GL_TRIANGLES, 0, 36, last - first);
+			}
+			else
+			{
+				for(size_t i = first; i < last; i++)
+				{
+					const InstanceData &instance = items[keys[i].item].instance;
+					program.shader->setMat4(program.modelLoc, instance.model);
+					program.shader->setMat3(program.normalLoc, instance.normal);
+					state.drawArrays(GL_TRIANGLES, 0, 36);
+				}
+			}
+
+			stats.batches++;
+			first = last;
+		}
+	}
+
+	// numbers of the last flush
+	const Stats &lastStats() const
+	{
+		return stats;
+	}
+
+	void release()
+	{
+		instances.release();
+	}
+
+private:
+	struct Program
+	{
+		const Shader *shader;
+		bool textured;
+		int modelLoc;
+		int normalLoc;
+		int instancedLoc;
+	};
+
+	struct Item
+	{
+		unsigned int program;
+		unsigned int VAO;
+		unsigned int diffuseTex;
+		unsigned int specularTex;
+		InstanceData instance;
+		// indices of a baked mesh, 0 for a single cube
+		unsigned int firstIndex;
+		unsigned int indexCount;
+	};
+
+	struct SortKey
+	{
+		uint64_t value;
+		uint32_t item;
+	};
+
+	// small dense index for a pair of GL names, so they fit in a few bits of the key
+	struct Slot
+	{
+		unsigned int first;
+		unsigned int second;
+	};
+
+	std::vector<Program> programs;
+	std::vector<Item> items;
+	std::vector<SortKey> keys;
+	std::vector<SortKey> scratch;
+	std::vector<InstanceData> sorted;
+	std::vector<Slot> vertexArrays;
+	std::vector<Slot> materials;
+	InstanceBuffer instances;
+	glm::vec3 viewPos;
+	const Frustum *frustum;
+	// culled this frame so far
+	unsigned int culled;
+	unsigned int culledObjects;
+	Stats stats;
+
+	static unsigned int slotOf(std::vector<Slot> &slots, unsigned int first, unsigned int second)
+	{
+		for(size_t i = 0; i < slots.size(); i++)
+		{
+			if(slots[i].first == first && slots[i].second == second)
+				return i;
+		}
+		Slot slot;
+		slot.first = first;
+		slot.second = second;
+		slots.push_back(slot);
+		return slots.size() - 1;
+	}
+
+	// add an item, sorted by its state and then by the squared distance from the camera to position
+	void push(const Item &item, const glm::vec3 &position)
+	{
+		// positive floats keep their order when compared as integers
+		glm::vec3 offset = position - viewPos;
+		float depth = glm::dot(offset, offset);
+		uint32_t depthBits;
+		memcpy(&depthBits, &depth, sizeof(depthBits));
+
+		// state first so matching cubes end up next to each other, then front to back
+		SortKey key;
+		key.value = ((uint64_t)(item.program & 0xFF) << 56) |
+			((uint64_t)(slotOf(vertexArrays, item.VAO, 0) & 0xFF) << 48) |
+			((uint64_t)(slotOf(materials, item.diffuseTex, item.specularTex) & 0xFFFF) << 32) |
+			depthBits;
+		key.item = items.size();
+
+		items.push_back(item);
+		keys.push_back(key);
+	}
+
+	// least significant digit radix sort, one byte per pass
+	void sortKeys()
+	{
+		size_t count = keys.size();
+		scratch.resize(count);
+		for(unsigned int shift = 0; shift < 64; shift += 8)
+		{
+			size_t histogram[256];
+			memset(histogram, 0, sizeof(histogram));
+			for(size_t i = 0; i < count; i++)
+				histogram[(keys[i].value >> shift) & 0xFF]++;
+
+			// every key has the same byte here, this pass would not move anything
+			if(histogram[(keys[0].value >> shift) & 0xFF] == count)
+				continue;
+
+			size_t offset = 0;
+			for(unsigned int b = 0; b < 256; b++)
+			{
+				size_t bucket = histogram[b];
+				histogram[b] = offset;
+				offset += bucket;
+			}
+			for(size_t i = 0; i < count; i++)
+				scratch[histogram[(keys[i].value >> shift) & 0xFF]++] = keys[i];
+			keys.swap(scratch);
+		}
+	}
+};
+#endif
@@ -0,0 +1,52 @@
+// EVERYTHING THE RENDERER NEEDS TO KNOW ABOUT THE GAME TO DRAW ONE FRAME, COPIED OUT OF THE WORLD
+// ONCE ITS UPDATE IS DONE, THE DRAW HELPERS IN "Source.cpp" ONLY EVER READ THIS
+
+#ifndef RENDER_SNAPSHOT_H
+#define RENDER_SNAPSHOT_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "MotionState.h"
+
+struct RenderSnapshot
+{
+	// positions to draw the player, lamp and Sven at, already blended between the last two ticks
+	MotionState motion;
+	// the same for every chasing creature, one entry per mob of the world's entity store
+	std::vector<float> mobX;
+	std::vector<float> mobY;
+	std::vector<float> mobZ;
+	std::vector<float> mobHeading;
+	std::vector<unsigned char> mobModel;
+	// view direction of the camera
+	glm::vec3 cameraFront;
+	glm::vec3 cameraUp;
+	// clock of the frame in seconds, for the purely visual animations (lamp spin, legs, tail, leaves)
+	float time;
+
+	// what the player holds
+	bool holdLamp;
+	bool holdSven;
+
+	// state of the game
+	bool gameIsHorror;
+	bool gameIsLost;
+	bool gameIsWon;
+
+	// display toggles
+	bool isDark;
+	bool orthographicToggle;
+	bool instancedToggle;
+	bool staticBatchToggle;
+	bool statsToggle;
+
+	// attenuation of the light source
+	float linearAtten;
+	float quadraticAtten;
+
+	// the player asked to quit
+	bool quitGame;
+};
+#endif
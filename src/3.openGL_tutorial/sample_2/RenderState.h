@@ -0,0 +1,153 @@
+// KEEPS TRACK OF THE BOUND PROGRAM, VERTEX ARRAY, TEXTURES AND DEPTH TEST
+// AND ONLY FORWARDS A CALL TO OPENGL WHEN IT WOULD ACTUALLY CHANGE SOMETHING
+
+#ifndef RENDER_STATE_H
+#define RENDER_STATE_H
+
+#include <glad/glad.h>
+
+// number of texture units tracked (the world shader samples from units 0 and 1)
+const unsigned int RENDER_STATE_TEXTURE_UNITS = 8;
+
+// sentinel for "not known", forces the next call through
+const unsigned int RENDER_STATE_UNKNOWN = 0xFFFFFFFF;
+
+class RenderState
+{
+public:
+	struct Counters
+	{
+		// state changing calls forwarded to OpenGL
+		unsigned int issued;
+		// redundant calls filtered out
+		unsigned int elided;
+		// glDrawArrays / glDrawArraysInstanced calls
+		unsigned int drawCalls;
+	};
+
+	RenderState()
+	{
+		invalidate();
+		current.issued = current.elided = current.drawCalls = 0;
+		lastFrame = current;
+	}
+
+	// forget everything, call after OpenGL state was changed behind the tracker's back
+	void invalidate()
+	{
+		program = RENDER_STATE_UNKNOWN;
+		vertexArray = RENDER_STATE_UNKNOWN;
+		activeUnit = RENDER_STATE_UNKNOWN;
+		for(unsigned int i = 0; i < RENDER_STATE_TEXTURE_UNITS; i++)
+			textures[i] = RENDER_STATE_UNKNOWN;
+		depthTest = RENDER_STATE_UNKNOWN;
+	}
+
+	// store this frame's counters and start counting again
+	void beginFrame()
+	{
+		lastFrame = current;
+		current.issued = current.elided = current.drawCalls = 0;
+	}
+
+	// counters of the last completed frame
+	const Counters &frameCounters() const
+	{
+		return lastFrame;
+	}
+
+	// counters of the frame in progress
+	const Counters &currentCounters() const
+	{
+		return current;
+	}
+
+	void useProgram(unsigned int id)
+	{
+		if(program == id)
+		{
+			current.elided++;
+			return;
+		}
+		glUseProgram(id);
+		program = id;
+		current.issued++;
+	}
+
+	void bindVertexArray(unsigned int id)
+	{
+		if(vertexArray == id)
+		{
+			current.elided++;
+			return;
+		}
+		glBindVertexArray(id);
+		vertexArray = id;
+		current.issued++;
+	}
+
+	// bind a 2D texture to a texture unit, switching the active unit only when needed
+	void bindTexture(unsigned int unit, unsigned int id)
+	{
+		if(unit < RENDER_STATE_TEXTURE_UNITS && textures[unit] == id)
+		{
+			current.elided++;
+			return;
+		}
+		if(activeUnit != unit)
+		{
+			glActiveTexture(GL_TEXTURE0 + unit);
+			activeUnit = unit;
+			current.issued++;
+		}
+		glBindTexture(GL_TEXTURE_2D, id);
+		if(unit < RENDER_STATE_TEXTURE_UNITS)
+			textures[unit] = id;
+		current.issued++;
+	}
+
+	void setDepthTest(bool enabled)
+	{
+		unsigned int value = enabled ? 1 : 0;
+		if(depthTest == value)
+		{
+			current.elided++;
+			return;
+		}
+		if(enabled)
+			glEnable(GL_DEPTH_TEST);
+		else
+			glDisable(GL_DEPTH_TEST);
+		depthTest = value;
+		current.issued++;
+	}
+
+	void drawArrays(GLenum mode, GLint first, GLsizei count)
+	{
+		glDrawArrays(mode, first, count);
+		current.drawCalls++;
+	}
+
+	void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances)
+	{
+		glDrawArraysInstanced(mode, first, count, instances);
+		current.drawCalls++;
+	}
+
+	void drawElements(GLenum mode, GLsizei count, GLenum type, const void *indices)
+	{
+		glDrawElements(mode, count, type, indices);
+		current.drawCalls++;
+	}
+
+private:
+	unsigned int program;
+	unsigned int vertexArray;
+	unsigned int activeUnit;
+	unsigned int textures[RENDER_STATE_TEXTURE_UNITS];
+	unsigned int depthTest;
+
+	Counters current;
+	Counters lastFrame;
+};
+#endif
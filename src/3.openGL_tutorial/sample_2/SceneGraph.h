@@ -0,0 +1,100 @@
+// A FLATTENED TRANSFORM HIERARCHY: EVERY NODE HAS A LOCAL MATRIX RELATIVE TO ITS PARENT, AND NODES ARE STORED
+// PARENTS FIRST, SO update() WORKS OUT EVERY WORLD MATRIX IN ONE PASS THAT REUSES THE PARENT'S RESULT
+// A NODE IS ONLY RECOMPUTED WHEN ITS OWN LOCAL MATRIX OR ONE OF ITS ANCESTORS CHANGED SINCE THE LAST update()
+
+#ifndef SCENE_GRAPH_H
+#define SCENE_GRAPH_H
+
+#include <glm/glm.hpp>
+
+#include <stddef.h>
+#include <string.h>
+
+#include <vector>
+
+class SceneGraph
+{
+public:
+	// parent of a root node
+	static const int NO_PARENT = -1;
+
+	// add a node below parent (added earlier, or NO_PARENT), returns its index
+	unsigned int add(int parent, const glm::mat4 &local)
+	{
+		parents.push_back(parent);
+		locals.push_back(local);
+		worlds.push_back(local);
+		dirty.push_back(1);
+		moved.push_back(0);
+		return parents.size() - 1;
+	}
+
+	// change the transform of a node relative to its parent, nothing is recomputed if it is the same
+	void setLocal(unsigned int node, const glm::mat4 &local)
+	{
+		if(memcmp(&locals[node], &local, sizeof(glm::mat4)) == 0)
+			return;
+		locals[node] = local;
+		dirty[node] = 1;
+	}
+
+	// bring the world matrix of every changed node and its descendants up to date
+	void update()
+	{
+		update(0, parents.size());
+	}
+
+	// the same for nodes first to end - 1 only, which must hold whole subtrees (a parent outside of them
+	// is taken as unchanged); the others keep their changes until a later update() reaches them
+	void update(size_t first, size_t end)
+	{
+		for(size_t i = first; i < end; i++)
+		{
+			int parent = parents[i];
+			if(dirty[i] || (parent >= (int)first && moved[parent]))
+			{
+				worlds[i] = parent == NO_PARENT ? locals[i] : worlds[parent] * locals[i];
+				moved[i] = 1;
+			}
+			else
+				moved[i] = 0;
+			dirty[i] = 0;
+		}
+	}
+
+	// transform of a node in world space, as of the last update()
+	const glm::mat4 &world(unsigned int node) const
+	{
+		return worlds[node];
+	}
+
+	// did the last update() change this node's world matrix?
+	bool hasMoved(unsigned int node) const
+	{
+		return moved[node] != 0;
+	}
+
+	size_t size() const
+	{
+		return parents.size();
+	}
+
+	void clear()
+	{
+		parents.clear();
+		locals.clear();
+		worlds.clear();
+		dirty.clear();
+		moved.clear();
+	}
+
+private:
+	std::vector<int> parents;
+	std::vector<glm::mat4> locals;
+	std::vector<glm::mat4> worlds;
+	// set by setLocal(), cleared by update()
+	std::vector<unsigned char> dirty;
+	// recomputed by the last update()
+	std::vector<unsigned char> moved;
+};
+#endif
@@ -12,6 +12,7 @@
 
 
 #include <string>
+#include <unordered_map>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -73,7 +74,8 @@ public:
 		// delete the shaders as they're linked into our program now and no longer necessery
 		glDeleteShader(vertex);
 		glDeleteShader(fragment);
-
+		// 3. remember where every active uniform lives so the setters never ask the driver
+		cacheUniformLocations();
 	}
 	// activate the shader
 	// ------------------------------------------------------------------------
@@ -81,66 +83,169 @@ public:
 	{
 		glUseProgram(ID);
 	}
+	// attach a uniform block of this program to a uniform buffer binding point
+	// ------------------------------------------------------------------------
+	void bindUniformBlock(const std::string &name, unsigned int binding) const
+	{
+		unsigned int index = glGetUniformBlockIndex(ID, name.c_str());
+		if (index != GL_INVALID_INDEX)
+			glUniformBlockBinding(ID, index, binding);
+	}
+	// returns the cached location of a uniform (-1 if it is not active in this program), names the
+	// cache doesn't know yet (such as "lights[2].position") are asked from OpenGL once and kept
+	// resolve hot uniforms once with this and pass the handle to the setters below
+	// ------------------------------------------------------------------------
+	int getUniformLocation(const std::string &name) const
+	{
+		std::unordered_map<std::string, int>::const_iterator it = uniformLocations.find(name);
+		if (it != uniformLocations.end())
+			return it->second;
+		int location = glGetUniformLocation(ID, name.c_str());
+		uniformLocations[name] = location;
+		return location;
+	}
 	// utility uniform functions
 	// ------------------------------------------------------------------------
 	void setBool(const std::string &name, bool value) const
 	{
-		glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+		setBool(getUniformLocation(name), value);
+	}
+	void setBool(int location, bool value) const
+	{
+		glUniform1i(location, (int)value);
 	}
 	// ------------------------------------------------------------------------
 	void setInt(const std::string &name, int value) const
 	{
-		glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+		setInt(getUniformLocation(name), value);
+	}
+	void setInt(int location, int value) const
+	{
+		glUniform1i(location, value);
 	}
 	// ------------------------------------------------------------------------
 	void setFloat(const std::string &name, float value) const
 	{
-		glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+		setFloat(getUniformLocation(name), value);
+	}
+	void setFloat(int location, float value) const
+	{
+		glUniform1f(location, value);
 	}
 	// ------------------------------------------------------------------------
 	void setVec2(const std::string &name, const glm::vec2 &value) const
 	{
-		glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		setVec2(getUniformLocation(name), value);
+	}
+	void setVec2(int location, const glm::vec2 &value) const
+	{
+		glUniform2fv(location, 1, &value[0]);
 	}
 	void setVec2(const std::string &name, float x, float y) const
 	{
-		glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+		setVec2(getUniformLocation(name), x, y);
+	}
+	void setVec2(int location, float x, float y) const
+	{
+		glUniform2f(location, x, y);
 	}
 	// ------------------------------------------------------------------------
 	void setVec3(const std::string &name, const glm::vec3 &value) const
 	{
-		glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		setVec3(getUniformLocation(name), value);
+	}
+	void setVec3(int location, const glm::vec3 &value) const
+	{
+		glUniform3fv(location, 1, &value[0]);
 	}
 	void setVec3(const std::string &name, float x, float y, float z) const
 	{
-		glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+		setVec3(getUniformLocation(name), x, y, z);
+	}
+	void setVec3(int location, float x, float y, float z) const
+	{
+		glUniform3f(location, x, y, z);
 	}
 	// ------------------------------------------------------------------------
 	void setVec4(const std::string &name, const glm::vec4 &value) const
 	{
-		glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		setVec4(getUniformLocation(name), value);
+	}
+	void setVec4(int location, const glm::vec4 &value) const
+	{
+		glUniform4fv(location, 1, &value[0]);
 	}
 	void setVec4(const std::string &name, float x, float y, float z, float w) const
 	{
-		glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+		setVec4(getUniformLocation(name), x, y, z, w);
+	}
+	void setVec4(int location, float x, float y, float z, float w) const
+	{
+		glUniform4f(location, x, y, z, w);
 	}
 	// ------------------------------------------------------------------------
 	void setMat2(const std::string &name, const glm::mat2 &mat) const
 	{
-		glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		setMat2(getUniformLocation(name), mat);
+	}
+	void setMat2(int location, const glm::mat2 &mat) const
+	{
+		glUniformMatrix2fv(location, 1, GL_FALSE, &mat[0][0]);
 	}
 	// ------------------------------------------------------------------------
 	void setMat3(const std::string &name, const glm::mat3 &mat) const
 	{
-		glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		setMat3(getUniformLocation(name), mat);
+	}
+	void setMat3(int location, const glm::mat3 &mat) const
+	{
+		glUniformMatrix3fv(location, 1, GL_FALSE, &mat[0][0]);
 	}
 	// ------------------------------------------------------------------------
 	void setMat4(const std::string &name, const glm::mat4 &mat) const
 	{
-		glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		setMat4(getUniformLocation(name), mat);
+	}
+	void setMat4(int location, const glm::mat4 &mat) const
+	{
+		glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]);
 	}
 
 private:
+	// uniform name -> location, the active uniforms filled in after linking, other names as they are first asked for
+	mutable std::unordered_map<std::string, int> uniformLocations;
+
+	// enumerate the program's active uniforms and store their locations (glGetActiveUniform only names
+	// the first element of an array, the other elements are resolved by getUniformLocation())
+	// ------------------------------------------------------------------------
+	void cacheUniformLocations()
+	{
+		GLint count = 0;
+		GLint maxLength = 0;
+		glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+		glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+		std::string name(maxLength > 0 ? maxLength : 1, '\0');
+		for (GLint i = 0; i < count; i++)
+		{
+			GLsizei length = 0;
+			GLint size = 0;
+			GLenum type = 0;
+			glGetActiveUniform(ID, (GLuint)i, maxLength, &length, &size, &type, &name[0]);
+			std::string uniformName(name.c_str(), length);
+
+			// members of uniform blocks have no location of their own
+			int location = glGetUniformLocation(ID, uniformName.c_str());
+			if (location == -1)
+				continue;
+			uniformLocations[uniformName] = location;
+
+			// arrays are reported as "name[0]", but may also be looked up as "name"
+			if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+				uniformLocations[uniformName.substr(0, uniformName.size() - 3)] = location;
+		}
+	}
+
 	// utility function for checking shader compilation/linking errors.
 	// ------------------------------------------------------------------------
 	void checkCompileErrors(GLuint shader, std::string type)
@@ -1,5 +1,7 @@
 #include <glad/glad.h>
+#ifndef SAMPLE_2_BENCHMARK
 #include <GLFW/glfw3.h>
+#endif
 #include <stb_image.h>
 
 #include <glm/glm.hpp>
@@ -9,58 +11,76 @@
 #include <learnopengl/filesystem.h>
 
 #include <iostream>
+#include <stdlib.h>
+#include <string.h>
 
-#define STB_IMAGE_IMPLEMENTATION
 #include "Shader.h"
 #include "Camera.h"
+#include "FrameData.h"
+#include "RenderContext.h"
+#include "Frustum.h"
+#include "StaticScene.h"
+#include "StaticBatch.h"
+#include "CreatureGraph.h"
+#include "NormalMatrix.h"
+#include "InputState.h"
+#include "InputRecording.h"
+#include "JobSystem.h"
+#include "TextureCache.h"
+#include "TextureLoader.h"
+#include "World.h"
+#include "RenderSnapshot.h"
+#include "UpdateThread.h"
+
+#ifdef SAMPLE_2_BENCHMARK
+#include "HeadlessContext.h"
+#include "Benchmark.h"
+#include "ChaseBenchmark.h"
+#include "ProximityBenchmark.h"
+#include "BvhBenchmark.h"
+#include "DxtBenchmark.h"
+#include "MipmapBenchmark.h"
+#include "ColorBenchmark.h"
+#include "UniformBenchmark.h"
+#include "NormalBenchmark.h"
+#endif
 
 // INITIALIZE OBJECTS IN WORLD SPACE
-void createGameOver(unsigned int VAO, unsigned int gameScreenTex, Shader lightingShader);
-void createGround(unsigned int VAO, unsigned int dirtTex, unsigned int dirtTex2, Shader lightingShader);
-void createSky(unsigned int VAO, unsigned int skyTex, Shader lightingShader);
-void createSven(unsigned int VAO, unsigned int svenBodyTex, unsigned int svenHeadTex, Shader lightingShader);
-void createWatersheep(unsigned int VAO, unsigned int waterSheepBodyTex, unsigned int waterSheepHeadTex, unsigned int waterSheepHeadTex2, Shader lightingShader);
-void createTree(unsigned int VAO, unsigned int woodTex, unsigned int woodTex2, unsigned int leafTex, unsigned int leafTex2, Shader lightingShader);
-void createZombie(unsigned int VAO, unsigned int zombieBodyTex, unsigned int zombieHeadTex, unsigned int zombieLegTex, unsigned int podzolTex, Shader lightingShader);
-void createLamp(unsigned int lightVAO, unsigned int VAO, unsigned int handleTex, Shader lightingShader, Shader lampShader, glm::mat4 projection, glm::mat4 orthographic, glm::mat4 view);
-void createPortal(unsigned int VAO, unsigned int structureTex, unsigned int portalTex, Shader lightingShader);
-
-// INTERACTION TOGGLES
-void resetGame();
-void checkGameStatus();
-void checkLampDistance();
-void checkSvenDistance();
-
+void createGameOver(const RenderContext &context, unsigned int gameScreenTex);
+void createCreatures(const RenderContext &context, CreatureGraph &creatures, const RenderSnapshot &frame);
+void createLamp(const RenderContext &context, const RenderSnapshot &frame);
+void createStaticScene(const RenderContext &context, const StaticScene &scene, const RenderSnapshot &frame, const Frustum *frustum);
+void createStaticBatch(const RenderContext &context, const StaticBatch &batch, const RenderSnapshot &frame, const Frustum *frustum);
+void staticMaterialTextures(const RenderContext &context, const RenderSnapshot &frame, unsigned int *materialTex);
+void drawCube(const RenderContext &context, unsigned int diffuseTex, unsigned int specularTex, const glm::mat4 &model);
+
+// DRAW ONE FRAME OF THE GAME FROM A SNAPSHOT OF THE WORLD
+void drawFrame(const RenderContext &context, const StaticScene &scene, const StaticBatch &batch, const RenderSnapshot &frame);
+
+// BUILD THE RIGS OF SVEN AND THE CREATURES, ONCE AND WHENEVER THE CREATURES CHANGE
+void rigCreatures(CreatureGraph &creatures, const RenderSnapshot &frame);
+void rigSven(CreatureGraph &creatures);
+void rigWatersheep(CreatureGraph &creatures);
+void rigZombie(CreatureGraph &creatures);
+
+// BAKE OBJECTS THAT NEVER MOVE, ONCE AT STARTUP
+void bakeGround(StaticScene &scene);
+void bakeSky(StaticScene &scene, StaticMaterial material);
+void bakeTree(StaticScene &scene, const EntityStore &trees);
+void bakePortal(StaticScene &scene);
+
+#ifdef SAMPLE_2_BENCHMARK
+int runSimulationBenchmark(Benchmark &benchmark);
+#endif
+
+#ifndef SAMPLE_2_BENCHMARK
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow *window);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void readInput(GLFWwindow *window, InputState &input);
+#endif
 
-// HELPER METHODS
-float* getRatio(float value1, float value2);
-void moveObject();
-void updateInput();
-unsigned int loadTexture(char const * path);
-
-// INITIAL POSITION OF CAMERA IN WORLD SPACE
-Camera camera(glm::vec3(0.0f, 0.6f, 9.0f));
-
-// INITIAL POSITION OF LAMP IN WORLD SPACE
-glm::vec3 lightPos(0.0f, 0.4f, 8.0f);
-
-// INITIAL POSITION OF SVEN IN WORLD SPACE
-glm::vec3 svenPos(-3.5f, 0.35f, -1.0f);
-
-// INITIAL POSITION OF WATER SHEEP IN WORLD SPACE
-glm::vec3 waterSheepPos(-2.5f, 0.35f, -7.0f);
-
-// INITIAL POSITION OF ZOMBIE IN WORLD SPACE
-glm::vec3 zombiePos(1.0f, 0.0f, 8.0f);
-
-// INITIAL POSITION OF PORTAL IN WORLD SPACE
-glm::vec3 portalPos(9.0f, 0.0f, 0.0f);
-
-// PI VALUE
-const float PI = 3.14159;
+// THE GAME ITSELF: PLAYER, LAMP, SVEN, CREATURES AND RULES, ONLY TOUCHED BY ITS UPDATE
+World world;
 
 // WIDTH & HEIGHT OF VIEWPORT
 const unsigned int SCR_WIDTH = 1600;
@@ -68,47 +88,137 @@ const unsigned int SCR_HEIGHT = 1200;
 
 bool firstMouse = false;
 
-// is the player holding the object?
-bool holdLamp = false;
-bool holdSven = false;
+// when the OpenGL state change counters were last printed
+float lastStatsTime = 0.0f;
 
-// toggle for orthographic/perspective projection
-bool orthographicToggle = false;
+// uniform buffer holding the per-frame camera and light state of every shader
+FrameDataBuffer frameDataBuffer;
 
-// toggles for object interaction
-bool lampIsClose;
-bool svenIsClose;
-bool gameIsHorror;
-bool gameIsLost;
-bool gameIsWon;
+// the rigs of Sven and the creatures, kept from frame to frame so only what moved is recomputed
+CreatureGraph creatures;
 
-// is the scene dark?
-bool isDark = false;
+// skip cubes and creatures outside the view frustum (the benchmark can turn it off to compare)
+bool frustumCulling = true;
 
-// is the player in the air?
-bool isJump;
-// position of camera during jump
-float POSITION_JUMP;
-// jump time of player
-float TIME_JUMP;
-
-// initial values for lighting
-float quadraticAtten = 0.25;
-float linearAtten = 0.7;
+// sphere around a creature's position that holds every cube of a water sheep or zombie, even a chasing zombie's swinging legs
+const glm::vec3 MOB_BOUNDS_OFFSET(0.0f, 0.5f, 0.0f);
+const float MOB_BOUNDS_RADIUS = 1.5f;
 
 float deltaTime = 0.0f;	
 float lastFrame = 0.0f;
+
 float lastX = 800.0f / 2.0;
 float lastY = 600.0 / 2.0;
 
-// used in updateInput()
-int LIGHT_DELAY = 0;
-int TOGGLE_DELAY = 0;
-int PICKUP_DELAY = 0;
-int ORTHO_DELAY = 0;
+// mouse movement received since the last readInput()
+float mouseOffsetX = 0.0f;
+float mouseOffsetY = 0.0f;
 
-int main()
+int main(int argc, char **argv)
 {
+#ifdef SAMPLE_2_BENCHMARK
+	// RUN HEADLESS WITH SCRIPTED INPUT AND A FIXED TIME STEP
+	BenchmarkOptions benchmarkOptions(SCR_WIDTH, SCR_HEIGHT);
+	if(!benchmarkOptions.parse(argc, argv))
+		return -1;
+	switch(benchmarkOptions.mode)
+	{
+	case BENCHMARK_CHASE:
+		return ChaseBenchmark(benchmarkOptions).run() ? 0 : -1;
+	case BENCHMARK_PROXIMITY:
+		return ProximityBenchmark(benchmarkOptions).run() ? 0 : -1;
+	case BENCHMARK_BVH:
+		return BvhBenchmark(benchmarkOptions).run() ? 0 : -1;
+	case BENCHMARK_DXT:
+		return DxtBenchmark(benchmarkOptions).run() ? 0 : -1;
+	case BENCHMARK_MIPMAP:
+		return MipmapBenchmark(benchmarkOptions).run() ? 0 : -1;
+	case BENCHMARK_YCOCG:
+		return ColorBenchmark(benchmarkOptions).run() ? 0 : -1;
+	case BENCHMARK_UNIFORMS:
+		return UniformBenchmark(benchmarkOptions).run() ? 0 : -1;
+	case BENCHMARK_NORMALS:
+		return NormalBenchmark(benchmarkOptions).run() ? 0 : -1;
+	case BENCHMARK_GAME:
+		break;
+	}
+	Benchmark benchmark(benchmarkOptions);
+	if(!benchmark.start())
+		return -1;
+	world.populate(benchmarkOptions.mobs, benchmarkOptions.trees);
+	JobSystem jobSystem(benchmarkOptions.jobs);
+	world.setJobSystem(&jobSystem);
+	if(benchmark.simulationOnly())
+		return runSimulationBenchmark(benchmark);
+
+	HeadlessContext headless;
+	if(!headless.create())
+		return -1;
+
+	if(!gladLoadGLLoader((GLADloadproc)HeadlessContext::procAddress))
+	{
+		std::cout << "Error in initialising and loading in GLAD" << std::endl;
+		return -1;
+	}
+	headless.createFramebuffer(benchmarkOptions.width, benchmarkOptions.height);
+	bool updateOnThread = benchmarkOptions.updateThread;
+	frustumCulling = !benchmarkOptions.noCulling;
+	world.staticBatchToggle = !benchmarkOptions.noBatching;
+	bool compressTextures = !benchmarkOptions.noTextureCache;
+#else
+	// "--record FILE" SAVES THE INPUT OF THIS SESSION, "--replay FILE" PLAYS A SAVED SESSION BACK
+	// "--update-thread" UPDATES THE WORLD ON A WORKER THREAD, "--mobs N" AND "--trees N" ADD EXTRA CREATURES AND TREES
+	// "--jobs N" SPREADS THE CREATURE SYSTEMS OVER N MORE THREADS, "--no-texture-cache" ALWAYS DECODES THE TEXTURE FILES
+	InputRecorder inputRecorder;
+	InputReplay inputReplay;
+	bool updateOnThread = false;
+	unsigned int extraMobs = 0;
+	unsigned int extraTrees = 0;
+	unsigned int jobWorkers = 0;
+	bool compressTextures = true;
+	for(int i = 1; i < argc; i++)
+	{
+		bool hasValue = i + 1 < argc;
+		if(!strcmp(argv[i], "--update-thread"))
+		{
+			updateOnThread = true;
+		}
+		else if(!strcmp(argv[i], "--mobs") && hasValue)
+		{
+			extraMobs = atoi(argv[++i]);
+		}
+		else if(!strcmp(argv[i], "--trees") && hasValue)
+		{
+			extraTrees = atoi(argv[++i]);
+		}
+		else if(!strcmp(argv[i], "--jobs") && hasValue)
+		{
+			jobWorkers = atoi(argv[++i]);
+		}
+		else if(!strcmp(argv[i], "--no-texture-cache"))
+		{
+			compressTextures = false;
+		}
+		else if(!strcmp(argv[i], "--record") && hasValue)
+		{
+			if(!inputRecorder.open(argv[++i]))
+				return -1;
+		}
+		else if(!strcmp(argv[i], "--replay") && hasValue)
+		{
+			if(!inputReplay.load(argv[++i]))
+				return -1;
+		}
+		else
+		{
+			std::cout << "usage: " << argv[0] << " [--record FILE] [--replay FILE] [--update-thread] [--mobs N] [--trees N] [--jobs N] [--no-texture-cache]" << std::endl;
+			return -1;
+		}
+	}
+	world.populate(extraMobs, extraTrees);
+	JobSystem jobSystem(jobWorkers);
+	world.setJobSystem(&jobSystem);
+
 	// INITIALIZE WINDOW
 	glfwInit();
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -135,6 +245,7 @@ int main()
 		std::cout << "Error in initialising and loading in GLAD" << std::endl;
 		return -1;
 	}
+#endif
 
 	// LOAD WORLD AND LAMP SHADERS
 	Shader lightingShader("lightingVS.vs", "lightingFS.fs");
@@ -199,29 +310,50 @@ int main()
 		-0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
 	};
 
-	// LOAD OBJECT TEXTURES
-	unsigned int handleTex = loadTexture(FileSystem::getPath("resources/textures/handle.jpg").c_str());
-	unsigned int skyTex = loadTexture(FileSystem::getPath("resources/textures/sky.jpg").c_str());
-	unsigned int skyTex2 = loadTexture(FileSystem::getPath("resources/textures/bars.png").c_str());
-	unsigned int dirtTex = loadTexture(FileSystem::getPath("resources/textures/dirt.jpg").c_str());
-	unsigned int dirtTex2 = loadTexture(FileSystem::getPath("resources/textures/bloody.png").c_str());
-	unsigned int svenBodyTex = loadTexture(FileSystem::getPath("resources/textures/svenBody.jpg").c_str());
-	unsigned int svenHeadTex = loadTexture(FileSystem::getPath("resources/textures/svenHead.png").c_str());
-	unsigned int waterSheepBodyTex = loadTexture(FileSystem::getPath("resources/textures/waterSheepBody.jpg").c_str());
-	unsigned int waterSheepHeadTex = loadTexture(FileSystem::getPath("resources/textures/sheepHead.jpg").c_str());
-	unsigned int waterSheepHeadTex2 = loadTexture(FileSystem::getPath("resources/textures/waterSheepFace.png").c_str());
-	unsigned int woodTex = loadTexture(FileSystem::getPath("resources/textures/wood.jpg").c_str());
-	unsigned int woodTex2 = loadTexture(FileSystem::getPath("resources/textures/obsidian.png").c_str());
-	unsigned int leafTex = loadTexture(FileSystem::getPath("resources/textures/leaf.png").c_str());	
-	unsigned int leafTex2 = loadTexture(FileSystem::getPath("resources/textures/netherack.png").c_str());
-	unsigned int zombieBodyTex = loadTexture(FileSystem::getPath("resources/textures/zombieBody.jpg").c_str());
-	unsigned int zombieHeadTex = loadTexture(FileSystem::getPath("resources/textures/zombieHead.jpg").c_str());
-	unsigned int zombieLegTex = loadTexture(FileSystem::getPath("resources/textures/denim.jpeg").c_str());
-	unsigned int podzolTex = loadTexture(FileSystem::getPath("resources/textures/podzol.jpg").c_str());
-	unsigned int gameOverTex = loadTexture(FileSystem::getPath("resources/textures/gameover.png").c_str());
-	unsigned int gameWinTex = loadTexture(FileSystem::getPath("resources/textures/gamewin.jpg").c_str());
-	unsigned int structureTex = loadTexture(FileSystem::getPath("resources/textures/glowstone.jpeg").c_str());
-	unsigned int portalTex = loadTexture(FileSystem::getPath("resources/textures/portal.jpeg").c_str());
+	// LOAD OBJECT TEXTURES: EVERY FILE IS DECODED AT ONCE ON A POOL OF THREADS, THEN UPLOADED HERE
+	// (AS DXT BLOCKS FROM THE TEXTURE CACHE WHEN THE DRIVER SUPPORTS THEM)
+	WorldTextures textures;
+	TextureLoader textureLoader;
+	TextureCache textureCache(FileSystem::getPath("resources/textures/cache"));
+	if(compressTextures)
+	{
+		if(TextureCache::supported())
+			textureLoader.setCache(&textureCache);
+		else
+			std::cout << "Compressed textures are not supported, decoding every texture file" << std::endl;
+	}
+	textureLoader.add(FileSystem::getPath("resources/textures/handle.jpg"), &textures.handle);
+	textureLoader.add(FileSystem::getPath("resources/textures/sky.jpg"), &textures.sky);
+	textureLoader.add(FileSystem::getPath("resources/textures/bars.png"), &textures.sky2);
+	textureLoader.add(FileSystem::getPath("resources/textures/dirt.jpg"), &textures.dirt);
+	textureLoader.add(FileSystem::getPath("resources/textures/bloody.png"), &textures.dirt2);
+	textureLoader.add(FileSystem::getPath("resources/textures/svenBody.jpg"), &textures.svenBody);
+	textureLoader.add(FileSystem::getPath("resources/textures/svenHead.png"), &textures.svenHead);
+	textureLoader.add(FileSystem::getPath("resources/textures/waterSheepBody.jpg"), &textures.waterSheepBody);
+	textureLoader.add(FileSystem::getPath("resources/textures/sheepHead.jpg"), &textures.waterSheepHead);
+	textureLoader.add(FileSystem::getPath("resources/textures/waterSheepFace.png"), &textures.waterSheepHead2);
+	textureLoader.add(FileSystem::getPath("resources/textures/wood.jpg"), &textures.wood);
+	textureLoader.add(FileSystem::getPath("resources/textures/obsidian.png"), &textures.wood2);
+	textureLoader.add(FileSystem::getPath("resources/textures/leaf.png"), &textures.leaf);
+	textureLoader.add(FileSystem::getPath("resources/textures/netherack.png"), &textures.leaf2);
+	textureLoader.add(FileSystem::getPath("resources/textures/zombieBody.jpg"), &textures.zombieBody);
+	textureLoader.add(FileSystem::getPath("resources/textures/zombieHead.jpg"), &textures.zombieHead);
+	textureLoader.add(FileSystem::getPath("resources/textures/denim.jpeg"), &textures.zombieLeg);
+	textureLoader.add(FileSystem::getPath("resources/textures/podzol.jpg"), &textures.podzol);
+	textureLoader.add(FileSystem::getPath("resources/textures/gameover.png"), &textures.gameOver);
+	textureLoader.add(FileSystem::getPath("resources/textures/gamewin.jpg"), &textures.gameWin);
+	textureLoader.add(FileSystem::getPath("resources/textures/glowstone.jpeg"), &textures.structure);
+	textureLoader.add(FileSystem::getPath("resources/textures/portal.jpeg"), &textures.portal);
+	{
+		JobSystem loaderJobs(JobSystem::workersPerCore());
+		textureLoader.decode(loaderJobs);
+	}
+	textureLoader.upload();
+#ifdef SAMPLE_2_BENCHMARK
+	benchmark.setTextureLoader(&textureLoader);
+#else
+	textureLoader.printTimes(std::cout);
+#endif
 
 
 
@@ -253,386 +385,296 @@ int main()
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
 	glEnableVertexAttribArray(0);
 
-	// ACTIVATE WORLD SHADER
-	lightingShader.use();
-	lightingShader.setInt("material.diffuse", 0);
-	lightingShader.setInt("material.specular", 1);
-
-	while (!glfwWindowShouldClose(window))
-	{
-    
-		float currentFrame = glfwGetTime();
-		deltaTime = currentFrame - lastFrame;
-		lastFrame = currentFrame;
+	// SORTS EVERY CUBE OF THE FRAME BY STATE AND FEEDS BOTH VAOS PER-INSTANCE MODEL AND NORMAL MATRICES
+	RenderQueue queue;
+	queue.attach(VAO);
+	queue.attach(lightVAO);
 
-        // set background colour to black
-		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-		glEnable(GL_DEPTH_TEST);
-        
-        // prevent overlapping of front-facing sides
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        
-        // prevent flickering
-		updateInput();
-
-		lightingShader.use();
-		// set initial position of light
-		lightingShader.setVec3("light.position", lightPos);
-
-        // set initial camera position
-		lightingShader.setVec3("viewPos", camera.Position);
-		
-		// check game status
-		checkGameStatus();
+	// TRACK BOUND STATE SO REDUNDANT BINDS BETWEEN DRAWS ARE SKIPPED
+	RenderState state;
 
-        // toggle the darkness/brightness of the scene
-		if(isDark)
-		{
-        	// increase ambient, diffuse, and specular values
-			lightingShader.setVec3("light.ambient", 2.1f, 2.1f, 2.1f);
-			lightingShader.setVec3("light.diffuse", 0.3f, 0.3f, 0.3f);
-			lightingShader.setVec3("light.specular", 1.0f, 1.0f, 1.0f);
-			
-            // increase attenuation value
-			lightingShader.setFloat("light.constant", 1.0f);
-			lightingShader.setFloat("light.linear", 1.0f);
-			lightingShader.setFloat("light.quadratic", 1.0f);
-		}
-		else
-		{
-			// decrease ambient, diffuse, and specular values
-			lightingShader.setVec3("light.ambient", 0.4f, 0.4f, 0.4f);
-			lightingShader.setVec3("light.diffuse", 0.3f, 0.3f, 0.3f);
-			lightingShader.setVec3("light.specular", 1.0f, 1.0f, 1.0f);
+	// EVERYTHING THE DRAW HELPERS NEED, PASSED AROUND BY REFERENCE
+	RenderContext context(lightingShader, lampShader, VAO, lightVAO, textures, queue, state);
 
-			// decrease attenuation value to defaults
-			lightingShader.setFloat("light.constant", 0.01f);
-			lightingShader.setFloat("light.linear", linearAtten);
-			lightingShader.setFloat("light.quadratic", quadraticAtten);
-		}	
+	// BAKE THE MATRICES OF EVERYTHING THAT NEVER MOVES
+	StaticScene staticScene;
+	bakeSky(staticScene, STATIC_SKY);
+	bakeSky(staticScene, STATIC_BARS);
+	bakeTree(staticScene, world.trees);
+	bakePortal(staticScene);
+	bakeGround(staticScene);
+	staticScene.finish();
+	world.setScenery(&staticScene.bvh);
 
-		// default lighting values
-        lightingShader.setFloat("light.constant", 1.0f);
-        lightingShader.setFloat("light.linear", linearAtten);
-		lightingShader.setFloat("light.quadratic", quadraticAtten);
+	// AND MERGE THEM INTO ONE MESH IN WORLD SPACE
+	StaticBatch staticBatch;
+	staticBatch.build(staticScene, vertices, sizeof(vertices) / (8 * sizeof(float)));
 
+	// SHARE ONE PER-FRAME UNIFORM BUFFER BETWEEN BOTH SHADERS
+	frameDataBuffer.create();
+	lightingShader.bindUniformBlock("FrameData", FRAME_DATA_BINDING);
+	lampShader.bindUniformBlock("FrameData", FRAME_DATA_BINDING);
 
-        // the lamp is being held
-		if(holdLamp)
-		{
-			glm::vec3 tempPosition = camera.Position;
-			glm::vec3 tempFront = camera.Front;
+	// ACTIVATE WORLD SHADER
+	lightingShader.use();
+	lightingShader.setInt("material.diffuse", 0);
+	lightingShader.setInt("material.specular", 1);
+	lightingShader.setFloat("material.shininess", 32.0f);
 
-			// floating animation of lamp and light source
-			tempPosition.y = tempPosition.y + sin(glfwGetTime()) / 60;
-			tempFront.y = tempFront.y +sin(glfwGetTime() * 3) / 40;
+	// the light source is always drawn at full intensity
+	lampShader.use();
+	lampShader.setFloat("intensity", 1.0);
 
-            // position lamp in front of player
-			lightPos = tempPosition + tempFront;
+	// the setup above bound things without going through the tracker
+	state.invalidate();
 
-            // prevent lamp from going below the ground
-			if(lightPos.y <= 0.2)
-			{
-				lightPos.y = 0.2;
-			}
-		}
-		else
-		{
-			// slower floating animation
-			lightPos.y = lightPos.y + sin(glfwGetTime() * 10) / 250;
-			if(lightPos.y <= 0.2)
-			{
-				lightPos.y = 0.2;
-			}
-		}
-
-		// Sven is being held
-		if(holdSven)
-		{
-			glm::vec3 tempPosition = camera.Position;
-			glm::vec3 tempFront = camera.Front;
-			
-			svenPos = tempPosition + tempFront;
-			if(svenPos.y <= 0.35)
-			{
-				svenPos.y = 0.35;
-			}
+	// UPDATE THE WORLD FOR THE NEXT FRAME WHILE THIS ONE IS DRAWN
+	UpdateThread *updateThread = NULL;
+	if(updateOnThread)
+		updateThread = new UpdateThread(world);
 
-			// turn the game into horror mode
-			gameIsHorror = true;
-		}
+	InputState input;
+	RenderSnapshot frame;
+	world.snapshot(frame);
+#ifdef SAMPLE_2_BENCHMARK
+	while (!frame.quitGame && !benchmark.finished())
+	{
+		benchmark.beginFrame();
+		float currentFrame = benchmark.time();
+#else
+	while (!frame.quitGame && !glfwWindowShouldClose(window))
+	{
+		// a replay decides the clock of every frame as well as its input
+		if(inputReplay.isOpen() && inputReplay.finished())
+			break;
+		float currentFrame = inputReplay.isOpen() ? inputReplay.time() : glfwGetTime();
+#endif
+		deltaTime = currentFrame - lastFrame;
+		lastFrame = currentFrame;
+		state.beginFrame();
 
-		lightingShader.setFloat("material.shininess", 32.0f);
-        
-		// INITIALIZE PERSPECTIVE PROJECTION MATRIX
-		glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-        
-		// INITIALIZE ORTHOGRAPHIC PROJECTION MATRIX
-		glm::mat4 orthographic = glm::ortho(-20.0f, 20.0f, -20.0f, 20.0f, 0.0f, 20.0f);
-		glm::mat4 view = camera.GetViewMatrix();
-
-		// TOGGLE BETWEEN PERSPECTIVE/ORTHOGRAPHIC PROJECTION
-		if(orthographicToggle)
+		// print last frame's state change counters once a second
+		if(frame.statsToggle && currentFrame - lastStatsTime >= 1.0f)
 		{
-			lightingShader.setMat4("projection", orthographic);
+			lastStatsTime = currentFrame;
+			const RenderState::Counters &counters = state.frameCounters();
+			const RenderQueue::Stats &queueStats = queue.lastStats();
+			std::cout << "GL STATE: " << counters.issued << " calls issued, " << counters.elided << " elided, " << counters.drawCalls << " draw calls, "
+				<< queueStats.items << " cubes in " << queueStats.batches << " batches, "
+				<< queueStats.culled << " cubes and " << queueStats.culledObjects << " creatures culled" << std::endl;
 		}
 
+		// react to the keys and mouse movement since the last frame before anything is drawn
+#ifdef SAMPLE_2_BENCHMARK
+		benchmark.nextInput(input);
+#else
+		if(inputReplay.isOpen())
+			input = inputReplay.read();
 		else
-		{
-			lightingShader.setMat4("projection", projection);
+			readInput(window, input);
+		inputRecorder.write(currentFrame, input);
+#endif
 
-		}
-		lightingShader.setMat4("view", view);
-		
-		// GAME OVER SCREEN
-		if(gameIsLost)
-		{
-			// display game over screen
-			camera.Front = glm::vec3(0.0f, 0.0f, -1.0f);
-			camera.Position.x = 0.0f;
-			camera.Position.z = 0.0f;
-			camera.Pitch = 0.0f;
-			camera.Yaw = -90.0f;
-			orthographicToggle = true;
-			isDark = true;
-			createGameOver(VAO, gameOverTex, lightingShader);
-		}
-		else if(gameIsWon)
+		// RUN THE SIMULATION TICKS THIS FRAME'S TIME ADDS UP TO, THEN DRAW BETWEEN THE LAST TWO
+		if(updateThread)
 		{
-			// display game won screen
-			camera.Front = glm::vec3(0.0f, 0.0f, -1.0f);
-			camera.Position.x = 0.0f;
-			camera.Position.z = 0.0f;
-			camera.Pitch = 0.0f;
-			camera.Yaw = -90.0f;
-			isDark = true;
-			orthographicToggle = true;
-			createGameOver(VAO, gameWinTex, lightingShader);
+			// draw the previous frame's snapshot while the worker works out this one,
+			// which puts the picture one frame behind the input
+			updateThread->start(input, deltaTime);
+			drawFrame(context, staticScene, staticBatch, frame);
+			updateThread->finish(frame);
 		}
 		else
 		{
-			// CREATE OBJECTS IN WORLD SPACE
-			if(!gameIsHorror)
-				createSky(VAO, skyTex, lightingShader);
-			createSky(VAO, skyTex2, lightingShader);
-			createTree(VAO, woodTex, woodTex2, leafTex, leafTex2, lightingShader);
-			createPortal(VAO, structureTex, portalTex, lightingShader);
-			createGround(VAO, dirtTex, dirtTex2, lightingShader);
-			createSven(VAO, svenBodyTex, svenHeadTex, lightingShader);
-			createWatersheep(VAO, waterSheepBodyTex, waterSheepHeadTex, waterSheepHeadTex2, lightingShader);
-			createZombie(VAO, zombieBodyTex, zombieHeadTex, zombieLegTex, podzolTex, lightingShader);
-			createLamp(lightVAO, VAO, handleTex, lightingShader, lampShader, projection, orthographic, view);
+			world.update(input, deltaTime, frame);
+			drawFrame(context, staticScene, staticBatch, frame);
 		}
 
-		/*
-			SOURCE(S):
-				https://www.gamedev.net/forums/topic/490713-jump-formula/
-		*/
-		// if the player is jumping, perform gravity calculations
-		if(isJump)
-		{
-			float gravity = -6.0;
-			camera.Position.y = POSITION_JUMP + 6 * (2 * TIME_JUMP + gravity * pow(TIME_JUMP, 2));
-            
-            // the player is falling
-			if((camera.Position.y < POSITION_JUMP) && TIME_JUMP > 0)
-			{
-				isJump = false;
-				camera.Position.y = POSITION_JUMP;
-			}
-		}
-		processInput(window);
-
+#ifdef SAMPLE_2_BENCHMARK
+		benchmark.endFrame(state.currentCounters(), queue.lastStats());
+	}
+	benchmark.writeReport();
+#else
 		glfwSwapBuffers(window);
 		glfwPollEvents();
 	}
+#endif
+	delete updateThread;
 
 	glDeleteVertexArrays(1, &VAO);
 	glDeleteVertexArrays(1, &lightVAO);
 	glDeleteBuffers(1, &VBO);
+	staticBatch.release();
+	queue.release();
+	frameDataBuffer.release();
 
+#ifdef SAMPLE_2_BENCHMARK
+	headless.release();
+#else
 	glfwTerminate();
+#endif
 
 	return 0;
 }
 
-// CAPTURE KEYBOARD INPUT
-void processInput(GLFWwindow *window)
+// DRAW ONE FRAME OF THE GAME FROM A SNAPSHOT OF THE WORLD, NOTHING HERE READS OR CHANGES THE WORLD ITSELF
+void drawFrame(const RenderContext &context, const StaticScene &scene, const StaticBatch &batch, const RenderSnapshot &frame)
 {
-	// exit the game
-	if(glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-	{
-		glfwSetWindowShouldClose(window, true);
-	}
+    // set background colour to black
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	context.state.setDepthTest(true);
+    
+    // prevent overlapping of front-facing sides
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	// exit the game
-	if(glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS)
-	{
-		resetGame();
-	}
+	// camera and light state for this frame, uploaded to the uniform buffer in one go
+	FrameData frameData;
 
-	// jump upwards
-	if(glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS && !isJump)
-	{
-		TIME_JUMP = 0;
-		isJump = true;
-		POSITION_JUMP = camera.Position.y;
-	}
+	// set initial position of light
+	frameData.light.position = frame.motion.lightPosition;
 
-	// move forwards
-	if(glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-	{
-		camera.ProcessKeyboard(FORWARD, deltaTime, isJump);
-		moveObject();
-	}
-	// move backwards
-	if(glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-	{
-		camera.ProcessKeyboard(BACKWARD, deltaTime, isJump);
-		moveObject();
-	}
+    // set initial camera position
+	frameData.viewPos = frame.motion.cameraPosition;
 
-	// move to the left
-	if(glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+    // toggle the darkness/brightness of the scene
+	if(frame.isDark)
 	{
-		camera.ProcessKeyboard(LEFT, deltaTime, isJump);
-		moveObject();
+    	// increase ambient, diffuse, and specular values
+		frameData.light.ambient = glm::vec3(2.1f, 2.1f, 2.1f);
+		frameData.light.diffuse = glm::vec3(0.3f, 0.3f, 0.3f);
+		frameData.light.specular = glm::vec3(1.0f, 1.0f, 1.0f);
+		
+        // increase attenuation value
+		frameData.light.constant = 1.0f;
+		frameData.light.linear = 1.0f;
+		frameData.light.quadratic = 1.0f;
 	}
-	
-	// move to the right
-	if(glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+	else
 	{
-		camera.ProcessKeyboard(RIGHT, deltaTime, isJump);
-		moveObject();
-	}
+		// decrease ambient, diffuse, and specular values
+		frameData.light.ambient = glm::vec3(0.4f, 0.4f, 0.4f);
+		frameData.light.diffuse = glm::vec3(0.3f, 0.3f, 0.3f);
+		frameData.light.specular = glm::vec3(1.0f, 1.0f, 1.0f);
+
+		// decrease attenuation value to defaults
+		frameData.light.constant = 0.01f;
+		frameData.light.linear = frame.linearAtten;
+		frameData.light.quadratic = frame.quadraticAtten;
+	}	
+
+	// default lighting values
+    frameData.light.constant = 1.0f;
+    frameData.light.linear = frame.linearAtten;
+	frameData.light.quadratic = frame.quadraticAtten;
+
+	// INITIALIZE PERSPECTIVE PROJECTION MATRIX
+	glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
     
-	// interact with lamp 
-	if(glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS && PICKUP_DELAY == 0)
+	// INITIALIZE ORTHOGRAPHIC PROJECTION MATRIX
+	glm::mat4 orthographic = glm::ortho(-20.0f, 20.0f, -20.0f, 20.0f, 0.0f, 20.0f);
+	glm::mat4 view = glm::lookAt(frame.motion.cameraPosition, frame.motion.cameraPosition + frame.cameraFront, frame.cameraUp);
+
+	// TOGGLE BETWEEN PERSPECTIVE/ORTHOGRAPHIC PROJECTION
+	if(frame.orthographicToggle)
 	{
-		PICKUP_DELAY = 20;
-		checkLampDistance();
-	
-		if(lampIsClose && !holdLamp)
-			holdLamp = true;
-		else if(holdLamp)
-			holdLamp = false;
+		frameData.projection = orthographic;
 	}
 
-	// interact with Sven 
-	if(glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS && PICKUP_DELAY == 0)
+	else
 	{
-		PICKUP_DELAY = 20;
-		checkSvenDistance();
+		frameData.projection = projection;
+
+	}
+	frameData.view = view;
+	frameDataBuffer.upload(frameData);
+
+	// whatever the projection, only what lies inside its frustum is queued
+	Frustum frustum;
+	frustum.extract(frameData.projection * view);
+	const Frustum *culling = frustumCulling ? &frustum : NULL;
+	context.queue.begin(frame.motion.cameraPosition, culling);
 	
-		if(svenIsClose && !holdSven)
-			holdSven = true;
-		else if(holdSven)
-			holdSven = false;
+	// GAME OVER SCREEN
+	if(frame.gameIsLost)
+	{
+		createGameOver(context, context.textures.gameOver);
 	}
-
-	// toggle type of projection
-	if(glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS && ORTHO_DELAY == 0)
+	else if(frame.gameIsWon)
 	{
-		ORTHO_DELAY = 20;
-		if(!orthographicToggle)
-			orthographicToggle = true;
-		else
-			orthographicToggle = false;
+		createGameOver(context, context.textures.gameWin);
 	}
-
-    	// toggle dark or bright scenery 
-	if(glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS && LIGHT_DELAY == 0)
+	else
 	{
-		LIGHT_DELAY = 20;
-		if(!isDark)
-			isDark = true;
+		// CREATE OBJECTS IN WORLD SPACE
+		if(frame.staticBatchToggle)
+			createStaticBatch(context, batch, frame, culling);
 		else
-			isDark = false;
+			createStaticScene(context, scene, frame, culling);
+		createCreatures(context, creatures, frame);
+		createLamp(context, frame);
 	}
 
-	// increase attenuation of light source
-	if(glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS)
-	{
-		linearAtten /= 1.2;
-		quadraticAtten /= 1.2*1.2;
-        
-        if(linearAtten <= 0.05f)
-			linearAtten = 0.05f;
-
-		if(quadraticAtten <= 0.0075)
-			quadraticAtten = 0.0075;
-	}
+	// sort and draw everything submitted by the create functions above
+	context.queue.flush(context.state, frame.instancedToggle);
+}
 
-	// decrease attenuation of light source
-	if(glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS)
+#ifdef SAMPLE_2_BENCHMARK
+// RUN THE SCRIPTED (OR REPLAYED) GAME WITHOUT RENDERING, NO OPENGL CONTEXT IS NEEDED
+int runSimulationBenchmark(Benchmark &benchmark)
+{
+	InputState input;
+	RenderSnapshot frame;
+	world.snapshot(frame);
+	while (!frame.quitGame && !benchmark.finished())
 	{
-		linearAtten *= 1.2;
-		quadraticAtten *= 1.2*1.2;
-
-		if(linearAtten >= 0.8)
-			linearAtten = 0.8;
+		benchmark.beginFrame();
+		float currentFrame = benchmark.time();
+		deltaTime = currentFrame - lastFrame;
+		lastFrame = currentFrame;
 
-		if(quadraticAtten >= 2.0)
-			quadraticAtten = 2.0;
+		benchmark.nextInput(input);
+		world.update(input, deltaTime, frame);
+		benchmark.endSimulationFrame();
 	}
+	return benchmark.writeReport() ? 0 : -1;
 }
+#endif
 
 // CREATE GAME OVER SCREEN
-void createGameOver(unsigned int VAO, unsigned int gameScreenTex, Shader lightingShader)
+void createGameOver(const RenderContext &context, unsigned int gameScreenTex)
 {
-	glBindVertexArray(VAO);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, gameScreenTex);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, gameScreenTex);
 	glm::mat4 model = glm::mat4();
 	model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.1f));
 	model = glm::scale(model, glm::vec3(30.0f, 20.0f, 5.0f));
-	lightingShader.setMat4("model", model);
-	glDrawArrays(GL_TRIANGLES, 0, 36);
+	drawCube(context, gameScreenTex, gameScreenTex, model);
 }
 
 // CREATE LAMP OBJECT IN WORLD SPACE
-void createLamp(unsigned int lightVAO, unsigned int VAO, unsigned int handleTex, Shader lightingShader, Shader lampShader, glm::mat4 projection, glm::mat4 orthographic, glm::mat4 view)
+void createLamp(const RenderContext &context, const RenderSnapshot &frame)
 {
 	// the handle
-	glBindVertexArray(VAO);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, handleTex);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, 0);
 	glm::mat4 model;
 	model = glm::mat4();
-	model = glm::translate(model, lightPos);
+	model = glm::translate(model, frame.motion.lightPosition);
 	model = glm::scale(model, glm::vec3(0.1f, 0.3f, 0.1f));
-	lightingShader.setMat4("model", model);
-	glDrawArrays(GL_TRIANGLES, 0, 36);
+	drawCube(context, context.textures.handle, 0, model);
 
 	// the light source
-	glBindVertexArray(lightVAO);
-	lampShader.use();
-	if(orthographicToggle)
-		lampShader.setMat4("projection", orthographic);
-	else
-		lampShader.setMat4("projection", projection);
 	model = glm::mat4();
-	model = glm::translate(model, lightPos);
+	model = glm::translate(model, frame.motion.lightPosition);
 	model = glm::translate(model, glm::vec3(0.0f, 0.2, 0.0f));
-	if(holdLamp)
+	if(frame.holdLamp)
 	{
-		model = glm::rotate(model, (float)glfwGetTime() * 10, glm::vec3(0.0f, 1.0f, 0.0f));
+		model = glm::rotate(model, frame.time * 10, glm::vec3(0.0f, 1.0f, 0.0f));
 	}
 	else
-		model = glm::rotate(model, (float)glfwGetTime(), glm::vec3(0.0f, 1.0f, 0.0f));
+		model = glm::rotate(model, frame.time, glm::vec3(0.0f, 1.0f, 0.0f));
 	model = glm::scale(model, glm::vec3(0.1f, 0.1f, 0.1f)); // a smaller cube
-	lampShader.setMat4("view", view);
-	lampShader.setFloat("intensity", 1.0);
-	lampShader.setMat4("model", model);
-	glDrawArrays(GL_TRIANGLES, 0, 36);
+	context.queue.submit(context.lampProgram, context.lightVAO, 0, 0, model, glm::mat3());
 }
 
-// CREATE PORTAL OBJECT IN WORLD SPACE
-void createPortal(unsigned int VAO, unsigned int structureTex, unsigned int portalTex, Shader lightingShader)
+// BAKE PORTAL OBJECT IN WORLD SPACE
+void bakePortal(StaticScene &scene)
 {
 	// the portal consists of 14 blocks
 	glm::vec3 blockPositions[] = 
@@ -655,21 +697,15 @@ void createPortal(unsigned int VAO, unsigned int structureTex, unsigned int port
 		glm::vec3(0.0f, 1.8f, -0.2f),
 	};
 
-	glBindVertexArray(VAO);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, structureTex);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, structureTex);
 	int numberOfBlocks = sizeof(blockPositions)/sizeof(blockPositions[0]);
 	// render all 14 blocks of the portal
 	for(int i = 0; i < numberOfBlocks; i++)
 	{	
 		glm::mat4 model = glm::mat4();
-		model = glm::translate(model, portalPos);
+		model = glm::translate(model, world.portalPos);
 		model = glm::translate(model, blockPositions[i]);
 		model = glm::scale(model, glm::vec3(0.4f));
-		lightingShader.setMat4("model", model);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
+		scene.add(STATIC_STRUCTURE, model);
 	}
 
 	// the portal's insides consists of 6 blocks
@@ -683,26 +719,20 @@ void createPortal(unsigned int VAO, unsigned int structureTex, unsigned int port
 		glm::vec3(0.0f, 1.4f, -0.2f),
 	};
 
-	glBindVertexArray(VAO);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, portalTex);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, portalTex);
 	int numberOfPortals = sizeof(portalPositions)/sizeof(portalPositions[0]);
 	// render the insides of the portal
 	for(int i = 0; i < numberOfPortals; i++)
 	{	
 		glm::mat4 model = glm::mat4();
-		model = glm::translate(model, portalPos);
+		model = glm::translate(model, world.portalPos);
 		model = glm::translate(model, portalPositions[i]);
 		model = glm::scale(model, glm::vec3(0.01f, 0.4f, 0.4f));
-		lightingShader.setMat4("model", model);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
+		scene.add(STATIC_PORTAL, model);
 	}
 }
 
-// CREATE SKY WALL OBJECTS IN WORLD SPACE
-void createSky(unsigned int VAO, unsigned int skyTex, Shader lightingShader)
+// BAKE SKY WALL OBJECTS IN WORLD SPACE
+void bakeSky(StaticScene &scene, StaticMaterial material)
 {
 	glm::vec3 skyPositions[] = 
 	{
@@ -732,69 +762,44 @@ void createSky(unsigned int VAO, unsigned int skyTex, Shader lightingShader)
 		glm::vec3(20.0f, 0.01f, 20.0f)
 	};
 
-	glBindVertexArray(VAO);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, skyTex);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, skyTex);
 	// render all 5 planes of sky
 	for(int i = 0; i < 5; i++)
 	{	
 		glm::mat4 model = glm::mat4();
 		model = glm::translate(model, skyPositions[i]);
 		model = glm::scale(model, skyScales[i]);
-		lightingShader.setMat4("model", model);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
+		scene.add(material, model);
 	}
 }
 
-// CREATE GROUND PLANE OBJECT IN WORLD SPACE
-void createGround(unsigned int VAO, unsigned int dirtTex, unsigned int dirtTex2, Shader lightingShader)
+// BAKE GROUND PLANE OBJECT IN WORLD SPACE
+void bakeGround(StaticScene &scene)
 {
-	if(gameIsHorror)
-		dirtTex = dirtTex2;
-
-	glBindVertexArray(VAO);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, dirtTex);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, dirtTex);
 	glm::mat4 model = glm::mat4();
 	model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.0f));
 	model = glm::scale(model, glm::vec3(20.0f, 0.01f, 20.0f));
-	lightingShader.setMat4("model", model);
-	glDrawArrays(GL_TRIANGLES, 0, 36);
+	scene.add(STATIC_GROUND, model);
 }
 
-// CREATE WATER SHEEP OBJECT IN WORLD SPACE
-void createSven(unsigned int VAO, unsigned int svenBodyTex, unsigned int svenHeadTex, Shader lightingShader)
+// RIG SVEN: EVERY PART HANGS OFF A ROOT AT SVEN'S POSITION, THE TAIL OFF A JOINT THAT WAGS WHILE SVEN IS HELD
+void rigSven(CreatureGraph &creatures)
 {
+	unsigned int rig = creatures.beginRig();
+	unsigned int root = creatures.addNode(SceneGraph::NO_PARENT, glm::mat4());
+	creatures.rigs[rig].root = root;
+
 	glm::mat4 model;
 
 	// Sven's head
-	glBindVertexArray(VAO);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, svenHeadTex);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, svenHeadTex);
 	model = glm::mat4();
-	model = glm::translate(model, svenPos);
 	model = glm::scale(model, glm::vec3(0.25f, 0.25f, 0.25f));
-	lightingShader.setMat4("model", model);
-	glDrawArrays(GL_TRIANGLES, 0, 36);
+	creatures.addPart(root, model, SKIN_SVEN_HEAD, PART_ALWAYS);
 
 	// Sven's body
-	glBindVertexArray(VAO);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, svenBodyTex);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, svenBodyTex);
 	model = glm::mat4();
-	model = glm::translate(model, svenPos);
 	model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.25f));
 	model = glm::scale(model, glm::vec3(0.275f, 0.275f, 0.5f));
-	lightingShader.setMat4("model", model);
-	glDrawArrays(GL_TRIANGLES, 0, 36);
+	creatures.addPart(root, model, SKIN_SVEN_BODY, PART_ALWAYS);
 
 	// Sven's legs
 	glm::vec3 legPositions[] = {
@@ -807,124 +812,44 @@ void createSven(unsigned int VAO, unsigned int svenBodyTex, unsigned int svenHea
 		// back right leg
 		glm::vec3(0.075f, -0.2f, 0.4f),
 	};
-	glBindVertexArray(VAO);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, svenBodyTex);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, svenBodyTex);
 	for(int i = 0; i < 4; i++)
 	{
 		model = glm::mat4();
-		model = glm::translate(model, svenPos);
 		model = glm::translate(model, legPositions[i]);
 		model = glm::scale(model, glm::vec3(0.075f, 0.3f, 0.075f));
-		lightingShader.setMat4("model", model);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
+		creatures.addPart(root, model, SKIN_SVEN_BODY, PART_ALWAYS);
 	}
 
 	// Sven's tail
-	glBindVertexArray(VAO);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, svenBodyTex);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, svenBodyTex);
+	unsigned int tail = creatures.addNode(root, glm::mat4());
+	creatures.rigs[rig].joints[0] = tail;
 	model = glm::mat4();
-	model = glm::translate(model, svenPos);
-	if(holdSven)
-		model = glm::rotate(model, sin((float)glfwGetTime() * 5), glm::vec3(0.0f, 0.0f, 1.0f));
 	model = glm::translate(model, glm::vec3(0.0f, -0.1f, 0.525f));
 	model = glm::scale(model, glm::vec3(0.075f, 0.3f, 0.075f));
-	lightingShader.setMat4("model", model);
-	glDrawArrays(GL_TRIANGLES, 0, 36);
+	creatures.addPart(tail, model, SKIN_SVEN_BODY, PART_ALWAYS);
 }
 
-// CREATE WATER SHEEP OBJECT IN WORLD SPACE
-void createWatersheep(unsigned int VAO, unsigned int waterSheepBodyTex, unsigned int waterSheepHeadTex, unsigned int waterSheepHeadTex2, Shader lightingShader)
+// RIG WATER SHEEP: THE ROOT TURNS THE WHOLE SHEEP TO ITS HEADING AROUND A POINT BEHIND ITS HEAD
+void rigWatersheep(CreatureGraph &creatures)
 {
-	glm::mat4 model;
-	float sheepRotation = ((180 * PI) / 180);
-	float* xzRatio;
-	xzRatio = getRatio(camera.Position.x, camera.Position.z);
-	float xVelocity = 0.25f * xzRatio[0] * deltaTime;
-	float zVelocity = 0.25f * xzRatio[1] * deltaTime;
+	unsigned int rig = creatures.beginRig();
+	unsigned int root = creatures.addNode(SceneGraph::NO_PARENT, glm::mat4());
+	creatures.rigs[rig].root = root;
 
-	glm::vec3 playerPosition = camera.Position - waterSheepPos;
+	glm::mat4 model;
 	glm::vec3 rotationAxis = glm::vec3(0.0f, 0.0f, -0.5f);
-
-	if(gameIsHorror)
-	{
-		waterSheepHeadTex = waterSheepHeadTex2;
-		// DEFINE ZOMBIE AI
-		// if zombie isn't in the players range, then chase the player
-		if(playerPosition.x > 0.0f && playerPosition.z > 0.0f)
-		{
-			sheepRotation = ((180 * PI) / 180) + atan(playerPosition.x / playerPosition.z);
-			// if water sheep isn't in the players range, then chase the player
-			if((glm::length(camera.Position - waterSheepPos)) > 0.5f)
-			{
-				waterSheepPos.x += xVelocity;
-				waterSheepPos.z += zVelocity;
-			}
-		}
-		else if(playerPosition.x > 0.0f && playerPosition.z < 0.0f)
-		{
-			sheepRotation = atan(playerPosition.x / playerPosition.z);
-			// if water sheep isn't in the players range, then chase the player
-			if((glm::length(camera.Position - waterSheepPos)) > 0.5f)
-			{
-				waterSheepPos.x += xVelocity;
-				waterSheepPos.z -= zVelocity;
-			}
-		}
-		else if(playerPosition.x < 0.0f && playerPosition.z < 0.0f)
-		{
-			sheepRotation = atan(playerPosition.x / playerPosition.z);
-			// if water sheep isn't in the players range, then chase the player
-			if((glm::length(camera.Position - waterSheepPos)) > 0.5f)
-			{
-				waterSheepPos.x -= xVelocity;
-				waterSheepPos.z -= zVelocity;
-			}
-		}
-		else if(playerPosition.x < 0.0f && playerPosition.z > 0.0f)
-		{
-			sheepRotation = ((180 * PI) / 180) + atan(playerPosition.x / playerPosition.z);
-			if((glm::length(camera.Position - waterSheepPos)) > 0.5f)
-			{
-				waterSheepPos.x -= xVelocity;
-				waterSheepPos.z += zVelocity;
-			}
-		}
-	}
+	unsigned int pivot = creatures.addNode(root, glm::translate(glm::mat4(), rotationAxis));
 
 	// Water sheep's head
-	glBindVertexArray(VAO);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, waterSheepHeadTex);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, waterSheepHeadTex);
 	model = glm::mat4();
-	model = glm::translate(model, waterSheepPos);
-	model = glm::rotate(model, sheepRotation, glm::vec3(0.0f, 1.0f, 0.0f));
-	model = glm::translate(model, rotationAxis);
 	model = glm::scale(model, glm::vec3(0.25f, 0.25f, 0.25f));
-	lightingShader.setMat4("model", model);
-	glDrawArrays(GL_TRIANGLES, 0, 36);
+	creatures.addPart(pivot, model, SKIN_SHEEP_HEAD, PART_ALWAYS);
 
 	// Water sheep's body
-	glBindVertexArray(VAO);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, waterSheepBodyTex);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, waterSheepBodyTex);
 	model = glm::mat4();
-	model = glm::translate(model, waterSheepPos);
-	model = glm::rotate(model, sheepRotation, glm::vec3(0.0f, 1.0f, 0.0f));
-	model = glm::translate(model, rotationAxis);
 	model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.25f));
 	model = glm::scale(model, glm::vec3(0.275f, 0.275f, 0.5f));
-	lightingShader.setMat4("model", model);
-	glDrawArrays(GL_TRIANGLES, 0, 36);
+	creatures.addPart(pivot, model, SKIN_SHEEP_BODY, PART_ALWAYS);
 
 	// Water sheeps's legs
 	glm::vec3 legPositions[] = {
@@ -937,259 +862,182 @@ void createWatersheep(unsigned int VAO, unsigned int waterSheepBodyTex, unsigned
 		// back right leg
 		glm::vec3(0.075f, -0.2f, 0.4f),
 	};
-	glBindVertexArray(VAO);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, waterSheepBodyTex);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, waterSheepBodyTex);
 	for(int i = 0; i < 4; i++)
 	{
 		model = glm::mat4();
-		model = glm::translate(model, waterSheepPos);
-		model = glm::rotate(model, sheepRotation, glm::vec3(0.0f, 1.0f, 0.0f));
-		model = glm::translate(model, rotationAxis);
 		model = glm::translate(model, legPositions[i]);
 		model = glm::scale(model, glm::vec3(0.075f, 0.3f, 0.075f));
-		lightingShader.setMat4("model", model);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
+		creatures.addPart(pivot, model, SKIN_SHEEP_BODY, PART_ALWAYS);
 	}
 }
 
-// CREATE ZOMBIE OBJECT IN WORLD SPACE
-void createZombie(unsigned int VAO, unsigned int zombieBodyTex, unsigned int zombieHeadTex, unsigned int zombieLegTex, unsigned int podzolTex, Shader lightingShader)
+// RIG ZOMBIE: A CALM ZOMBIE IS A HEAD AND AN ARM POKING OUT OF THE GROUND, A CHASING ONE STANDS UP,
+// TURNS TO ITS HEADING AND SWINGS ITS LEGS FROM TWO HIP JOINTS
+void rigZombie(CreatureGraph &creatures)
 {
-	glm::mat4 model;
-	float zombieRotation = ((180 * PI) / 180);
-	float* xzRatio;
-	xzRatio = getRatio(camera.Position.x, camera.Position.z);
-	float xVelocity = 0.25f * xzRatio[0] * deltaTime;
-	float zVelocity = 0.25f * xzRatio[1] * deltaTime;
+	unsigned int rig = creatures.beginRig();
+	unsigned int root = creatures.addNode(SceneGraph::NO_PARENT, glm::mat4());
+	creatures.rigs[rig].root = root;
 
-	glm::vec3 playerPosition = camera.Position - zombiePos;
+	glm::mat4 model;
 	glm::vec3 rotationAxis = glm::vec3(0.0f, 0.0f, -0.5f);
 
-	if(gameIsHorror)
-	{
-		// DEFINE ZOMBIE AI
-		// if zombie isn't in the players range, then chase the player
-		if(playerPosition.x > 0.0f && playerPosition.z > 0.0f)
-		{
-			zombieRotation = ((180 * PI) / 180) + atan(playerPosition.x / playerPosition.z);
-			if((glm::length(camera.Position - zombiePos)) > 0.5f)
-			{
-				zombiePos.x += xVelocity;
-				zombiePos.z += zVelocity;
-			}
-		}
-		else if(playerPosition.x > 0.0f && playerPosition.z < 0.0f)
-		{
-			zombieRotation = atan(playerPosition.x / playerPosition.z);
-			if((glm::length(camera.Position - zombiePos)) > 0.5f)
-			{
-				zombiePos.x += xVelocity;
-				zombiePos.z -= zVelocity;
-			}
-		}
-		else if(playerPosition.x < 0.0f && playerPosition.z < 0.0f)
-		{
-			zombieRotation = atan(playerPosition.x / playerPosition.z);
-			if((glm::length(camera.Position - zombiePos)) > 0.5f)
-			{
-				zombiePos.x -= xVelocity;
-				zombiePos.z -= zVelocity;
-			}
-		}
-		else if(playerPosition.x < 0.0f && playerPosition.z > 0.0f)
-		{
-			zombieRotation = ((180 * PI) / 180) + atan(playerPosition.x / playerPosition.z);
-			if((glm::length(camera.Position - zombiePos)) > 0.5f)
-			{
-				zombiePos.x -= xVelocity;
-				zombiePos.z += zVelocity;
-			}
-		}
+	// the standing zombie turns around its rotation axis
+	unsigned int turn = creatures.addNode(root, glm::mat4());
+	creatures.rigs[rig].joints[0] = turn;
+	unsigned int body = creatures.addNode(turn, glm::translate(glm::mat4(), rotationAxis));
 
-		// zombie head
-		glBindVertexArray(VAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, zombieHeadTex);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, zombieHeadTex);
-		model = glm::mat4();
-		model = glm::translate(model, zombiePos);
-		model = glm::rotate(model, zombieRotation, glm::vec3(0.0f, 1.0f, 0.0f));
-		model = glm::translate(model, rotationAxis);
-		model = glm::translate(model, glm::vec3(0.0f, 1.0f, 0.0f));
-		model = glm::scale(model, glm::vec3(0.25f, 0.25f, 0.25f));
-		lightingShader.setMat4("model", model);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
-
-		// zombie torso
-		glBindVertexArray(VAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, zombieBodyTex);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, zombieBodyTex);
-		model = glm::mat4();
-		model = glm::translate(model, zombiePos);
-		model = glm::rotate(model, zombieRotation, glm::vec3(0.0f, 1.0f, 0.0f));
-		model = glm::translate(model, rotationAxis);
-		model = glm::translate(model, glm::vec3(0.0f, 0.7f, 0.0f));
-		model = glm::scale(model, glm::vec3(0.3f, 0.4f, 0.15f));
-		lightingShader.setMat4("model", model);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
-
-		// zombie left arm
-		glBindVertexArray(VAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, zombieBodyTex);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, zombieBodyTex);
-		model = glm::mat4();
-		model = glm::translate(model, zombiePos);
-		model = glm::rotate(model, zombieRotation, glm::vec3(0.0f, 1.0f, 0.0f));
-		model = glm::translate(model, rotationAxis);
-		model = glm::translate(model, glm::vec3(-0.225f, 0.8f, -0.15f));
-		model = glm::scale(model, glm::vec3(0.15f, 0.15f, 0.45f));
-		lightingShader.setMat4("model", model);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
-
-		// zombie right arm
-		glBindVertexArray(VAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, zombieBodyTex);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, zombieBodyTex);
-		model = glm::mat4();
-		model = glm::translate(model, zombiePos);
-		model = glm::rotate(model, zombieRotation, glm::vec3(0.0f, 1.0f, 0.0f));
-		model = glm::translate(model, rotationAxis);
-		model = glm::translate(model, glm::vec3(0.225f, 0.8f, -0.15f));
-		model = glm::scale(model, glm::vec3(0.15f, 0.15f, 0.45f));
-		lightingShader.setMat4("model", model);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
-
-		// zombie left leg
-		glBindVertexArray(VAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, zombieLegTex);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, zombieLegTex);
+	// zombie head
+	model = glm::mat4();
+	model = glm::translate(model, glm::vec3(0.0f, 1.0f, 0.0f));
+	model = glm::scale(model, glm::vec3(0.25f, 0.25f, 0.25f));
+	creatures.addPart(body, model, SKIN_ZOMBIE_HEAD, PART_HORROR);
+
+	// zombie torso
+	model = glm::mat4();
+	model = glm::translate(model, glm::vec3(0.0f, 0.7f, 0.0f));
+	model = glm::scale(model, glm::vec3(0.3f, 0.4f, 0.15f));
+	creatures.addPart(body, model, SKIN_ZOMBIE_BODY, PART_HORROR);
+
+	// zombie left arm
+	model = glm::mat4();
+	model = glm::translate(model, glm::vec3(-0.225f, 0.8f, -0.15f));
+	model = glm::scale(model, glm::vec3(0.15f, 0.15f, 0.45f));
+	creatures.addPart(body, model, SKIN_ZOMBIE_BODY, PART_HORROR);
+
+	// zombie right arm
+	model = glm::mat4();
+	model = glm::translate(model, glm::vec3(0.225f, 0.8f, -0.15f));
+	model = glm::scale(model, glm::vec3(0.15f, 0.15f, 0.45f));
+	creatures.addPart(body, model, SKIN_ZOMBIE_BODY, PART_HORROR);
+
+	// zombie legs, each swinging from a hip joint 0.2 above its centre
+	glm::vec3 hipPositions[] = {
+		// left leg
+		glm::vec3(0.075f, 0.3f, 0.0f),
+		// right leg
+		glm::vec3(-0.075f, 0.3f, 0.0f)
+	};
+	for(int i = 0; i < 2; i++)
+	{
 		model = glm::mat4();
-		model = glm::translate(model, zombiePos);
-		model = glm::rotate(model, zombieRotation, glm::vec3(0.0f, 1.0f, 0.0f));
-		model = glm::translate(model, rotationAxis);
-		model = glm::translate(model, glm::vec3(0.075f, 0.3f, 0.0f));
+		model = glm::translate(model, hipPositions[i]);
 		model = glm::translate(model, glm::vec3(0.0f, 0.2f, 0.0f));
-		model = glm::rotate(model, cos((float)glfwGetTime() * 5), glm::vec3(1.0f, 0.0f, 0.0f));
-		model = glm::translate(model, glm::vec3(0.0f, -0.2f, 0.0f));
-		model = glm::scale(model, glm::vec3(0.125f, 0.5f, 0.125f));
-		lightingShader.setMat4("model", model);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
-
-		// zombie right leg
-		glBindVertexArray(VAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, zombieLegTex);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, zombieLegTex);
+		unsigned int hip = creatures.addNode(body, model);
+		unsigned int swing = creatures.addNode(hip, glm::mat4());
+		creatures.rigs[rig].joints[1 + i] = swing;
+
 		model = glm::mat4();
-		model = glm::translate(model, zombiePos);
-		model = glm::rotate(model, zombieRotation, glm::vec3(0.0f, 1.0f, 0.0f));
-		model = glm::translate(model, rotationAxis);
-		model = glm::translate(model, glm::vec3(-0.075f, 0.3f, 0.0f));
-		model = glm::translate(model, glm::vec3(0.0f, 0.2f, 0.0f));
-		model = glm::rotate(model, sin((float)glfwGetTime() * 5), glm::vec3(1.0f, 0.0f, 0.0f));
 		model = glm::translate(model, glm::vec3(0.0f, -0.2f, 0.0f));
 		model = glm::scale(model, glm::vec3(0.125f, 0.5f, 0.125f));
-		lightingShader.setMat4("model", model);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
+		creatures.addPart(swing, model, SKIN_ZOMBIE_LEG, PART_HORROR);
 	}
-	else
+
+	// zombie head
+	model = glm::mat4();
+	model = glm::scale(model, glm::vec3(0.25f, 0.25f, 0.25f));
+	creatures.addPart(root, model, SKIN_ZOMBIE_HEAD, PART_CALM);
+
+	// podzol
+	model = glm::mat4();
+	model = glm::scale(model, glm::vec3(0.5f, 0.1f, 0.5f));
+	creatures.addPart(root, model, SKIN_PODZOL, PART_CALM);
+
+	// zombie arm
+	model = glm::mat4();
+	model = glm::translate(model, glm::vec3(0.3f, 0.0f, 0.0f));
+	model = glm::scale(model, glm::vec3(0.15f, 0.4f, 0.15f));
+	creatures.addPart(root, model, SKIN_ZOMBIE_BODY, PART_CALM);
+}
+
+// BUILD A RIG FOR SVEN AND ONE FOR EVERY CREATURE OF THE SNAPSHOT, RIG i + 1 IS MOB i
+void rigCreatures(CreatureGraph &creatures, const RenderSnapshot &frame)
+{
+	creatures.clear(frame.mobModel);
+	rigSven(creatures);
+	for(size_t i = 0; i < frame.mobModel.size(); i++)
 	{
-		// zombie head
-		glBindVertexArray(VAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, zombieHeadTex);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, zombieHeadTex);
-		model = glm::mat4();
-		model = glm::translate(model, zombiePos);
-		model = glm::scale(model, glm::vec3(0.25f, 0.25f, 0.25f));
-		lightingShader.setMat4("model", model);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
-
-		// podzol
-		glBindVertexArray(VAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, podzolTex);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, podzolTex);
-		model = glm::mat4();
-		model = glm::translate(model, zombiePos);
-		model = glm::scale(model, glm::vec3(0.5f, 0.1f, 0.5f));
-		lightingShader.setMat4("model", model);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
-
-		// zombie arm
-		glBindVertexArray(VAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, zombieBodyTex);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, zombieBodyTex);
-		model = glm::mat4();
-		model = glm::translate(model, zombiePos);
-		model = glm::translate(model, glm::vec3(0.3f, 0.0f, 0.0f));
-		model = glm::scale(model, glm::vec3(0.15f, 0.4f, 0.15f));
-		lightingShader.setMat4("model", model);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
+		if(frame.mobModel[i] == MODEL_ZOMBIE)
+			rigZombie(creatures);
+		else
+			rigWatersheep(creatures);
 	}
 }
 
-// CREATE TREE OBJECTS IN WORLD SPACE
-void createTree(unsigned int VAO, unsigned int woodTex, unsigned int woodTex2, unsigned int leafTex, unsigned int leafTex2, Shader lightingShader)
+// CREATE SVEN AND EVERY CHASING CREATURE ON SCREEN: POSE THE ROOTS AND JOINTS OF THEIR RIGS,
+// LET THE GRAPH WORK OUT WHAT MOVED, THEN QUEUE THE PARTS THAT BELONG TO THE CURRENT GAME MODE
+void createCreatures(const RenderContext &context, CreatureGraph &creatures, const RenderSnapshot &frame)
 {
-	// define positions of 4 trees
-	glm::vec3 treePositions[] =
+	if(!creatures.builtFor(frame.mobModel))
+		rigCreatures(creatures, frame);
+
+	SceneGraph &graph = creatures.graph;
+	creatures.visible.clear();
+
+	// Sven wags its tail while held
+	const CreatureGraph::Rig &sven = creatures.rigs[0];
+	graph.setLocal(sven.root, glm::translate(glm::mat4(), frame.motion.svenPosition));
+	if(frame.holdSven)
+		graph.setLocal(sven.joints[0], glm::rotate(glm::mat4(), sin(frame.time * 5), glm::vec3(0.0f, 0.0f, 1.0f)));
+	else
+		graph.setLocal(sven.joints[0], glm::mat4());
+	creatures.visible.push_back(0);
+
+	// every chasing creature of the world's entity store
+	for(size_t i = 0; i < frame.mobX.size(); i++)
 	{
-		glm::vec3(1.0f,0.0f,1.0f),
-		glm::vec3(1.0f,0.0f,-1.0f),
-		glm::vec3(-1.0f,0.0f,1.0f),
-		glm::vec3(-1.0f,0.0f,-1.0f),
-		glm::vec3(2.0f,0.0f,2.0f),
-		glm::vec3(2.0f,0.0f,-2.0f),
-		glm::vec3(-2.0f,0.0f,2.0f),
-		glm::vec3(-2.0f,0.0f,-2.0f),
-		glm::vec3(4.0f,0.0f,4.0f),
-		glm::vec3(4.0f,0.0f,-4.0f),
-		glm::vec3(-4.0f,0.0f,4.0f),
-		glm::vec3(-4.0f,0.0f,-4.0f),
-		glm::vec3(2.0f,0.0f,4.0f),
-		glm::vec3(2.0f,0.0f,-4.0f),
-		glm::vec3(-2.0f,0.0f,4.0f),
-		glm::vec3(-2.0f,0.0f,-4.0f),
-		glm::vec3(4.0f,0.0f,2.0f),
-		glm::vec3(4.0f,0.0f,-2.0f),
-		glm::vec3(-4.0f,0.0f,2.0f),
-		glm::vec3(-4.0f,0.0f,-2.0f),
-		glm::vec3(8.0f,0.0f,8.0f),
-		glm::vec3(8.0f,0.0f,-8.0f),
-		glm::vec3(-8.0f,0.0f,8.0f),
-		glm::vec3(-8.0f,0.0f,-8.0f),
-		glm::vec3(6.0f,0.0f,8.0f),
-		glm::vec3(6.0f,0.0f,-8.0f),
-		glm::vec3(-6.0f,0.0f,8.0f),
-		glm::vec3(-6.0f,0.0f,-8.0f),
-		glm::vec3(4.0f,0.0f,8.0f),
-		glm::vec3(4.0f,0.0f,-8.0f),
-		glm::vec3(-4.0f,0.0f,8.0f),
-		glm::vec3(-4.0f,0.0f,-8.0f),
-		glm::vec3(2.0f,0.0f,8.0f),
-		glm::vec3(2.0f,0.0f,-8.0f),
-		glm::vec3(-2.0f,0.0f,8.0f),
-		glm::vec3(-2.0f,0.0f,-8.0f)
-	};
+		glm::vec3 position(frame.mobX[i], frame.mobY[i], frame.mobZ[i]);
+		if(!context.queue.visible(position + MOB_BOUNDS_OFFSET, MOB_BOUNDS_RADIUS))
+			continue;
+		const CreatureGraph::Rig &rig = creatures.rigs[i + 1];
+		creatures.visible.push_back(i + 1);
+
+		glm::mat4 turn = glm::rotate(glm::mat4(), frame.mobHeading[i], glm::vec3(0.0f, 1.0f, 0.0f));
+		if(frame.mobModel[i] == MODEL_ZOMBIE)
+		{
+			graph.setLocal(rig.root, glm::translate(glm::mat4(), position));
+			// only the standing zombie turns and walks
+			if(frame.gameIsHorror)
+			{
+				graph.setLocal(rig.joints[0], turn);
+				graph.setLocal(rig.joints[1], glm::rotate(glm::mat4(), cos(frame.time * 5), glm::vec3(1.0f, 0.0f, 0.0f)));
+				graph.setLocal(rig.joints[2], glm::rotate(glm::mat4(), sin(frame.time * 5), glm::vec3(1.0f, 0.0f, 0.0f)));
+			}
+		}
+		else
+			graph.setLocal(rig.root, glm::translate(glm::mat4(), position) * turn);
+	}
+	creatures.update();
+
+	unsigned int skinTex[CREATURE_SKIN_COUNT];
+	skinTex[SKIN_SVEN_HEAD] = context.textures.svenHead;
+	skinTex[SKIN_SVEN_BODY] = context.textures.svenBody;
+	skinTex[SKIN_SHEEP_HEAD] = frame.gameIsHorror ? context.textures.waterSheepHead2 : context.textures.waterSheepHead;
+	skinTex[SKIN_SHEEP_BODY] = context.textures.waterSheepBody;
+	skinTex[SKIN_ZOMBIE_HEAD] = context.textures.zombieHead;
+	skinTex[SKIN_ZOMBIE_BODY] = context.textures.zombieBody;
+	skinTex[SKIN_ZOMBIE_LEG] = context.textures.zombieLeg;
+	skinTex[SKIN_PODZOL] = context.textures.podzol;
+
+	CreaturePartMode hidden = frame.gameIsHorror ? PART_CALM : PART_HORROR;
+	for(size_t v = 0; v < creatures.visible.size(); v++)
+	{
+		const CreatureGraph::Rig &rig = creatures.rigs[creatures.visible[v]];
+		unsigned int end = rig.firstPart + rig.partCount;
+		for(unsigned int p = rig.firstPart; p < end; p++)
+		{
+			const CreatureGraph::Part &part = creatures.parts[p];
+			if(part.mode == hidden)
+				continue;
+			unsigned int tex = skinTex[part.skin];
+			context.queue.submit(context.lightingProgram, context.VAO, tex, tex, graph.world(part.node), creatures.normal(p));
+		}
+	}
+}
 
+// BAKE TREE OBJECTS IN WORLD SPACE
+void bakeTree(StaticScene &scene, const EntityStore &trees)
+{
 	glm::vec3 woodPositions[] =
 	{
 		glm::vec3(0.0f,0.1f,0.0f),
@@ -1198,158 +1046,130 @@ void createTree(unsigned int VAO, unsigned int woodTex, unsigned int woodTex2, u
 		glm::vec3(0.0f,1.45f,0.0f)
 	};
 	
-	int numberOfTrees = sizeof(treePositions)/sizeof(treePositions[0]);
+	int numberOfTrees = trees.size();
 	glm::mat4 model;
-	if(gameIsHorror)
-	{
-		woodTex = woodTex2;
-		leafTex = leafTex2;
-	}
 
 	for(int i = 0; i < numberOfTrees; i++)
 	{
+		glm::vec3 treePosition = trees.position(i);
+
 		// trunk
-		glBindVertexArray(VAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, woodTex);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, woodTex);
-		model = glm::mat4();
 		for(int j = 0; j < 4; j++)
 		{
 			model = glm::mat4();
-			model = glm::translate(model, treePositions[i]);
+			model = glm::translate(model, treePosition);
 			model = glm::translate(model, woodPositions[j]);
 			model = glm::scale(model, glm::vec3(0.45f));
-			lightingShader.setMat4("model", model);
-			glDrawArrays(GL_TRIANGLES, 0, 36);
+			scene.add(STATIC_WOOD, model);
 		}
 
 		// leaves
-		glBindVertexArray(VAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, leafTex);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, leafTex);
 		model = glm::mat4();
-		model = glm::translate(model, treePositions[i]);
-		if(gameIsHorror)
-		{
-			model = glm::translate(model, glm::vec3(0.0f, sin((float)glfwGetTime() * 10) / 10, 0.0f));
-		}
+		model = glm::translate(model, treePosition);
 		model = glm::translate(model, glm::vec3(0.0f,2.5f,0.0f));
 		model = glm::scale(model, glm::vec3(1.70f));
-		lightingShader.setMat4("model", model);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
+		scene.add(STATIC_LEAF, model);
 	}
 
 }
 
-// RESET THE GAME
-void resetGame()
-{
-	// RESET CORE GAME TOGGLES
-	holdSven = false;
-	holdLamp = false;
-	gameIsLost = false;
-	gameIsWon = false;
-	gameIsHorror = false;
-	lampIsClose = false;
-	svenIsClose = false;
-	orthographicToggle = false;
-	isDark = false;
-
-	// RESET POSITION OF CAMERA IN WORLD SPACE
-	camera.Position = glm::vec3(0.0f, 0.6f, 9.0f);
-	camera.WorldUp = glm::vec3(0.0f, 1.0f, 0.0f);
-	camera.Front = glm::vec3(0.0f, 0.0f, -1.0f);
-
-	// RESET POSITION OF LAMP IN WORLD SPACE
-	lightPos = glm::vec3(0.0f, 0.4f, 8.0f);
-
-	// RESET POSITION OF SVEN IN WORLD SPACE
-	svenPos = glm::vec3(-3.5f, 0.35f, -1.0f);
-
-	// RESET POSITION OF WATER SHEEP IN WORLD SPACE
-	waterSheepPos = glm::vec3(-2.5f, 0.35f, -7.0f);
-
-	// RESET POSITION OF ZOMBIE IN WORLD SPACE
-	zombiePos = glm::vec3(1.0f, 0.0f, 8.0f);
-
-	// RESET POSITION OF PORTAL IN WORLD SPACE
-	portalPos = glm::vec3(9.0f, 0.0f, 0.0f);
-}
-
-// CHECK IF GAME IS LOST OR WON
-void checkGameStatus()
+// QUEUE THE BAKED STATIC CUBES, ONLY THEIR TEXTURES DEPEND ON THE GAME STATE
+// with a frustum, only the cubes its query of the scene's hierarchy finds are queued
+void createStaticScene(const RenderContext &context, const StaticScene &scene, const RenderSnapshot &frame, const Frustum *frustum)
 {
-	// has the zombie or water sheep caught the player?
-	if(gameIsHorror)
+	unsigned int materialTex[STATIC_MATERIAL_COUNT];
+	staticMaterialTextures(context, frame, materialTex);
+
+	// the leaves bob up and down in horror mode, a translation does not change the normal matrix
+	float leafOffset = 0.0f;
+	if(frame.gameIsHorror)
+		leafOffset = sin(frame.time * 10) * STATIC_LEAF_BOB;
+
+	// the blue sky is hidden behind the bars in horror mode
+	bool skipSky = frame.gameIsHorror;
+	unsigned int queued = 0;
+	auto queueCube = [&](unsigned int i)
 	{
-		if((glm::length(camera.Position - zombiePos)) <= 1.0f || (glm::length(camera.Position - waterSheepPos)) <= 0.5f)
-		{
-			gameIsLost = true;
-		}
+		StaticMaterial material = (StaticMaterial)scene.materials[i];
+		if(material == STATIC_SKY && skipSky)
+			return;
 
-		// has the player saved Sven?
-		if((glm::length(svenPos - portalPos)) <= 1.0f)
+		unsigned int tex = materialTex[material];
+		if(material == STATIC_LEAF && leafOffset != 0.0f)
 		{
-			gameIsWon = true;
-			gameIsLost = false;
+			glm::mat4 model = scene.models[i];
+			model[3][1] += leafOffset;
+			context.queue.submitVisible(context.lightingProgram, context.VAO, tex, tex, model, scene.normals[i]);
 		}
-	}
-}
+		else
+			context.queue.submitVisible(context.lightingProgram, context.VAO, tex, tex, scene.models[i], scene.normals[i]);
+		queued++;
+	};
 
-// CHECK DISTANCE OF LAMP TO PLAYER
-void checkLampDistance()
-{
-	// is the lamp close enough to be picked up?
-	if((glm::length(camera.Position - lightPos)) <= 1.2f)
+	if(frustum)
 	{
-		lampIsClose = true;
+		scene.bvh.queryFrustum(*frustum, queueCube);
+		unsigned int shown = scene.models.size() - (skipSky ? scene.count(STATIC_SKY) : 0);
+		context.queue.addCulled(shown - queued);
 	}
 	else
 	{
-		lampIsClose = false;
+		for(unsigned int i = 0; i < scene.models.size(); i++)
+			queueCube(i);
 	}
 }
 
-// CHECK DISTANCE OF SVEN TO PLAYER
-void checkSvenDistance()
+// QUEUE THE DRAW RANGES OF THE BAKED STATIC MESH, THE SAME CUBES AS createStaticScene() IN A FEW DRAW CALLS
+// with a frustum, ranges entirely outside it are skipped
+void createStaticBatch(const RenderContext &context, const StaticBatch &batch, const RenderSnapshot &frame, const Frustum *frustum)
 {
-	// is Sven close enough to be picked up?
-	if((glm::length(camera.Position - svenPos)) <= 1.2f)
-	{
-		svenIsClose = true;
-	}
-	else
+	unsigned int materialTex[STATIC_MATERIAL_COUNT];
+	staticMaterialTextures(context, frame, materialTex);
+
+	// the mesh is already in world space, only the bobbing leaves move it
+	glm::mat4 identity, leafModel;
+	if(frame.gameIsHorror)
+		leafModel = glm::translate(leafModel, glm::vec3(0.0f, sin(frame.time * 10) * STATIC_LEAF_BOB, 0.0f));
+
+	for(size_t i = 0; i < batch.ranges.size(); i++)
 	{
-		svenIsClose = false;
+		const StaticBatch::Range &range = batch.ranges[i];
+		// the blue sky is hidden behind the bars in horror mode
+		if(range.material == STATIC_SKY && frame.gameIsHorror)
+			continue;
+		if(frustum && !frustum->containsBox(range.center, range.extent))
+		{
+			context.queue.addCulled(range.indexCount / 36);
+			continue;
+		}
+
+		unsigned int tex = materialTex[range.material];
+		const glm::mat4 &model = range.material == STATIC_LEAF ? leafModel : identity;
+		context.queue.submitMesh(context.lightingProgram, batch.vertexArray(), tex, tex, model, glm::mat3(), range.firstIndex, range.indexCount, range.center);
 	}
 }
 
-// TRACK LAMP WITH CAMERA MOVEMENT
-void moveObject()
+// TEXTURE OF EVERY STATIC MATERIAL, HORROR MODE SWAPS MOST OF THEM
+void staticMaterialTextures(const RenderContext &context, const RenderSnapshot &frame, unsigned int *materialTex)
 {
-	if(holdLamp)
-	{
-		glm::vec3 tempPosition = camera.Position;
-		glm::vec3 tempFront = camera.Front;
-
-		tempPosition.y = tempPosition.y + +sin(glfwGetTime())/10;
-		tempFront.y = tempFront.y + +sin(glfwGetTime()+glfwGetTime()+ glfwGetTime() + glfwGetTime())/10;
-		lightPos = tempPosition + tempFront;		
-	}
+	const WorldTextures &textures = context.textures;
+	materialTex[STATIC_SKY] = textures.sky;
+	materialTex[STATIC_BARS] = textures.sky2;
+	materialTex[STATIC_WOOD] = frame.gameIsHorror ? textures.wood2 : textures.wood;
+	materialTex[STATIC_LEAF] = frame.gameIsHorror ? textures.leaf2 : textures.leaf;
+	materialTex[STATIC_STRUCTURE] = textures.structure;
+	materialTex[STATIC_PORTAL] = textures.portal;
+	materialTex[STATIC_GROUND] = frame.gameIsHorror ? textures.dirt2 : textures.dirt;
+}
 
-	if(holdSven)
-	{
-		glm::vec3 tempPosition = camera.Position;
-		glm::vec3 tempFront = camera.Front;
-			
-		svenPos = tempPosition + tempFront;
-	}
+// QUEUE A WORLD CUBE, IT IS DRAWN WHEN THE QUEUE IS FLUSHED AT THE END OF THE FRAME
+// every model matrix passed here is a translate/rotate/scale chain, so the cheap normal matrix applies
+void drawCube(const RenderContext &context, unsigned int diffuseTex, unsigned int specularTex, const glm::mat4 &model)
+{
+	context.queue.submit(context.lightingProgram, context.VAO, diffuseTex, specularTex, model, rotateScaleNormalMatrix(model));
 }
 
+#ifndef SAMPLE_2_BENCHMARK
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
 	
@@ -1375,115 +1195,25 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos)
 	lastX = xpos;
 	lastY = ypos;
 
-	camera.ProcessMouseMovement(xoffset, yoffset);
-}
-
-
-/*
-    SOURCE(s):
-	https://learnopengl.com/code_viewer_gh.php?code=src/2.lighting/4.2.lighting_maps_specular_map/lighting_maps_specular.cpp
-*/
-// LOAD A 2D TEXTURE FROM A FILE
-unsigned int loadTexture(char const * path)
-{
-	unsigned int textureID;
-	glGenTextures(1, &textureID);
-
-	int width, height, nrComponents;
-	unsigned char *data = stbi_load(path, &width, &height, &nrComponents, 0);
-	if(data)
-	{
-		GLenum format;
-		if(nrComponents == 1)
-			format = GL_RED;
-		else if(nrComponents == 3)
-			format = GL_RGB;
-		else if(nrComponents == 4)
-			format = GL_RGBA;
-
-		glBindTexture(GL_TEXTURE_2D, textureID);
-		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		stbi_image_free(data);
-	}
-	else
-	{
-		std::cout << "Texture failed to load at path: " << path << std::endl;
-		stbi_image_free(data);
-	}
-
-	return textureID;
+	// applied to the camera by World::simulate() on the next frame
+	mouseOffsetX += xoffset;
+	mouseOffsetY += yoffset;
 }
 
-/*
-    SOURCE(s):
-	Yong Yang Tan, Curtin University
-*/
-// FINDS THE RATIO OF TWO GIVEN FLOATS
-// RETURNS THE RATIO IN THE FORM OF AN ARRAY (POINTER)
-// WILL ALWAYS RETURN POSITIVE RATIOS
-float* getRatio(float value1, float value2)
+// SAMPLE THE KEYS THE GAME REACTS TO AND THE MOUSE MOVEMENT SINCE THE LAST FRAME
+void readInput(GLFWwindow *window, InputState &input)
 {
-	// get absolute value of both values
-	float number1 = fabs(value1);
-	float number2 = fabs(value2);
-
-	static float arr[2];
-	if(number1 > number2)
-	{
-        arr[0] = number1 / number2;
-		arr[1] = 1.0f;
-	}
-    else if(number1 < number2)
-	{
-        arr[0] = 1.0f;
-		arr[1] = number2 / number1;
-	}
-	else
-	{
-		arr[0] = 1.0f;
-		arr[1] = 1.0f;
-	}
-
-	return arr;
-}
-
-/*
-    SOURCE(s):
-	Antoni Liang, Curtin University
-*/
-// PREVENT FLICKERING WITH INPUT
-void updateInput()
-{
-	if(LIGHT_DELAY > 0)
-	{
-		LIGHT_DELAY -= 1.1;
-	}
+	// GLFW key of every InputKey, in the same order
+	static const int glfwKeys[INPUT_KEY_COUNT] = {
+		GLFW_KEY_ESCAPE, GLFW_KEY_R, GLFW_KEY_SPACE, GLFW_KEY_W, GLFW_KEY_S, GLFW_KEY_A, GLFW_KEY_D,
+		GLFW_KEY_F, GLFW_KEY_E, GLFW_KEY_P, GLFW_KEY_I, GLFW_KEY_M, GLFW_KEY_O, GLFW_KEY_L, GLFW_KEY_K, GLFW_KEY_B
+	};
 
-	if(TIME_JUMP < 0.5f)
-	{
-		TIME_JUMP += 0.01;
-	}
+	for(unsigned int i = 0; i < INPUT_KEY_COUNT; i++)
+		input.keys[i] = glfwGetKey(window, glfwKeys[i]) == GLFW_PRESS;
 
-	if(TOGGLE_DELAY > 0)
-	{
-		TOGGLE_DELAY -= 1;
-	}
-	
-	if(PICKUP_DELAY > 0)
-	{
-		PICKUP_DELAY -= 1;
-	}
-	
-	if(ORTHO_DELAY > 0)
-	{
-		ORTHO_DELAY -= 1;
-	}
+	input.mouseX = mouseOffsetX;
+	input.mouseY = mouseOffsetY;
+	mouseOffsetX = mouseOffsetY = 0.0f;
 }
-
+#endif
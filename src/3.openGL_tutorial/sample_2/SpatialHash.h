@@ -0,0 +1,134 @@
+// UNIFORM SPATIAL HASH OVER THE GROUND PLANE FOR "WHAT IS WITHIN r OF HERE?" QUERIES
+// THE GROUND IS CUT INTO SQUARE CELLS, EVERY CELL HASHES TO A BUCKET OF ENTRY IDS, SO A RADIUS QUERY
+// ONLY LOOKS AT THE FEW CELLS THE CIRCLE OVERLAPS INSTEAD OF AT EVERY ENTRY
+// ENTRIES ARE MOVED INCREMENTALLY: move() ONLY TOUCHES THE BUCKETS WHEN AN ENTRY CROSSES INTO ANOTHER CELL
+
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <glm/glm.hpp>
+
+#include <math.h>
+#include <stddef.h>
+
+#include <vector>
+
+class SpatialHash
+{
+public:
+	// cellSize is best about the largest query radius, bucketCount is rounded up to a power of two
+	SpatialHash(float cellSize, unsigned int bucketCount) : inverseCellSize(1.0f / cellSize)
+	{
+		unsigned int count = 1;
+		while(count < bucketCount)
+			count *= 2;
+		buckets.resize(count);
+	}
+
+	// add an entry at position, returns its id (ids count up from 0)
+	unsigned int add(const glm::vec3 &position)
+	{
+		unsigned int id = positions.size();
+		positions.push_back(position);
+		cellX.push_back(cellOf(position.x));
+		cellZ.push_back(cellOf(position.z));
+		bucketOf.push_back(bucketIndex(cellX[id], cellZ[id]));
+		slotOf.push_back(buckets[bucketOf[id]].size());
+		buckets[bucketOf[id]].push_back(id);
+		return id;
+	}
+
+	// an entry has moved, relinked only when it crossed into another cell
+	void move(unsigned int id, const glm::vec3 &position)
+	{
+		positions[id] = position;
+		int x = cellOf(position.x);
+		int z = cellOf(position.z);
+		if(x == cellX[id] && z == cellZ[id])
+			return;
+
+		unlink(id);
+		cellX[id] = x;
+		cellZ[id] = z;
+		bucketOf[id] = bucketIndex(x, z);
+		slotOf[id] = buckets[bucketOf[id]].size();
+		buckets[bucketOf[id]].push_back(id);
+	}
+
+	size_t size() const
+	{
+		return positions.size();
+	}
+
+	void clear()
+	{
+		for(size_t i = 0; i < buckets.size(); i++)
+			buckets[i].clear();
+		positions.clear();
+		cellX.clear();
+		cellZ.clear();
+		bucketOf.clear();
+		slotOf.clear();
+	}
+
+	// call visit(id, distance) for every entry within radius of center, measured in 3D like glm::length,
+	// stops early once visit returns true, returns whether it did
+	template<class Visit>
+	bool query(const glm::vec3 &center, float radius, const Visit &visit) const
+	{
+		int firstX = cellOf(center.x - radius), lastX = cellOf(center.x + radius);
+		int firstZ = cellOf(center.z - radius), lastZ = cellOf(center.z + radius);
+		float radius2 = radius * radius;
+		for(int z = firstZ; z <= lastZ; z++)
+		{
+			for(int x = firstX; x <= lastX; x++)
+			{
+				const std::vector<unsigned int> &bucket = buckets[bucketIndex(x, z)];
+				for(size_t i = 0; i < bucket.size(); i++)
+				{
+					unsigned int id = bucket[i];
+					// other cells can share the bucket, skip them so nothing is visited twice
+					if(cellX[id] != x || cellZ[id] != z)
+						continue;
+					glm::vec3 offset = positions[id] - center;
+					float distance2 = glm::dot(offset, offset);
+					if(distance2 <= radius2 && visit(id, sqrtf(distance2)))
+						return true;
+				}
+			}
+		}
+		return false;
+	}
+
+private:
+	int cellOf(float coordinate) const
+	{
+		return (int)floorf(coordinate * inverseCellSize);
+	}
+
+	unsigned int bucketIndex(int x, int z) const
+	{
+		// two large primes spread neighbouring cells over the buckets (Teschner et al. 2003)
+		return ((unsigned int)x * 73856093u ^ (unsigned int)z * 19349663u) & (buckets.size() - 1);
+	}
+
+	// take an entry out of its bucket, the last one of the bucket fills the gap
+	void unlink(unsigned int id)
+	{
+		std::vector<unsigned int> &bucket = buckets[bucketOf[id]];
+		unsigned int last = bucket.back();
+		bucket[slotOf[id]] = last;
+		slotOf[last] = slotOf[id];
+		bucket.pop_back();
+	}
+
+	float inverseCellSize;
+	std::vector<std::vector<unsigned int> > buckets;
+	// per entry: where it is, its cell, and where it sits in which bucket
+	std::vector<glm::vec3> positions;
+	std::vector<int> cellX;
+	std::vector<int> cellZ;
+	std::vector<unsigned int> bucketOf;
+	std::vector<unsigned int> slotOf;
+};
+#endif
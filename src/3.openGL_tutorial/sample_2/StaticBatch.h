@@ -0,0 +1,210 @@
+// THE STATIC SCENE BAKED INTO ONE MESH: THE VERTICES OF EVERY CUBE ARE MOVED TO WORLD SPACE ONCE AT STARTUP AND
+// STORED IN ONE VERTEX AND INDEX BUFFER, GROUPED BY MATERIAL AND SPLIT INTO DRAW RANGES OF NEARBY CUBES,
+// SO THE STATIC WORLD IS A HANDFUL OF DRAW CALLS INSTEAD OF A MATRIX UPLOADED AND SORTED FOR EVERY CUBE, EVERY FRAME
+
+#ifndef STATIC_BATCH_H
+#define STATIC_BATCH_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+#include "Frustum.h"
+#include "StaticScene.h"
+
+class StaticBatch
+{
+public:
+	// a material with more cubes is split in half along its longest axis until the pieces are this small,
+	// so the original map is one range per material and a big forest can still be culled piece by piece
+	static const unsigned int RANGE_CUBES = 256;
+
+	struct Range
+	{
+		StaticMaterial material;
+		// indices firstIndex to firstIndex + indexCount - 1 of the index buffer
+		unsigned int firstIndex;
+		unsigned int indexCount;
+		// bounds of the range's cubes, the leaves' grown by how far they bob
+		glm::vec3 center;
+		glm::vec3 extent;
+	};
+
+	// every draw range, the ranges of one material sit next to each other
+	std::vector<Range> ranges;
+
+	StaticBatch() : VAO(0), VBO(0), EBO(0) {}
+
+	// bake every cube of the scene, the unit cube is given as it is drawn by the world VAO:
+	// vertexCount vertices of 8 floats (position, normal, texture coordinates), three per triangle
+	void build(const StaticScene &scene, const float *cubeVertices, unsigned int vertexCount)
+	{
+		// the cube's distinct vertices, and its triangles as indices into them
+		std::vector<const float *> corners;
+		std::vector<unsigned int> cubeIndices;
+		for(unsigned int v = 0; v < vertexCount; v++)
+		{
+			const float *vertex = cubeVertices + v * 8;
+			unsigned int corner = 0;
+			while(corner < corners.size() && memcmp(corners[corner], vertex, 8 * sizeof(float)) != 0)
+				corner++;
+			if(corner == corners.size())
+				corners.push_back(vertex);
+			cubeIndices.push_back(corner);
+		}
+
+		// the cubes of every material, then split into ranges
+		std::vector<unsigned int> order(scene.models.size());
+		for(size_t i = 0; i < order.size(); i++)
+			order[i] = i;
+		std::vector<RangeCubes> pieces;
+		for(unsigned int m = 0; m < STATIC_MATERIAL_COUNT; m++)
+			split(scene, order, scene.first((StaticMaterial)m), scene.first((StaticMaterial)m) + scene.count((StaticMaterial)m), pieces);
+
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+		vertices.reserve(order.size() * corners.size());
+		indices.reserve(order.size() * cubeIndices.size());
+		ranges.clear();
+		for(size_t p = 0; p < pieces.size(); p++)
+		{
+			Range range;
+			range.material = (StaticMaterial)scene.materials[order[pieces[p].first]];
+			range.firstIndex = indices.size();
+			glm::vec3 low, high;
+			for(unsigned int k = pieces[p].first; k < pieces[p].end; k++)
+			{
+				const glm::mat4 &model = scene.models[order[k]];
+				const glm::mat3 &normal = scene.normals[order[k]];
+
+				glm::vec3 center, extent;
+				Frustum::cubeBounds(model, center, extent);
+				if(range.material == STATIC_LEAF)
+					extent.y += STATIC_LEAF_BOB;
+				low = k == pieces[p].first ? center - extent : glm::min(low, center - extent);
+				high = k == pieces[p].first ? center + extent : glm::max(high, center + extent);
+
+				unsigned int base = vertices.size();
+				for(size_t c = 0; c < corners.size(); c++)
+				{
+					const float *corner = corners[c];
+					Vertex vertex;
+					vertex.position = glm::vec3(model * glm::vec4(corner[0], corner[1], corner[2], 1.0f));
+					vertex.normal = normal * glm::vec3(corner[3], corner[4], corner[5]);
+					vertex.texCoords = glm::vec2(corner[6], corner[7]);
+					vertices.push_back(vertex);
+				}
+				for(size_t i = 0; i < cubeIndices.size(); i++)
+					indices.push_back(base + cubeIndices[i]);
+			}
+			range.indexCount = indices.size() - range.firstIndex;
+			range.center = 0.5f * (low + high);
+			range.extent = 0.5f * (high - low);
+			ranges.push_back(range);
+		}
+
+		upload(vertices, indices);
+	}
+
+	// vertex array of the baked mesh, with the same attributes as the world VAO
+	unsigned int vertexArray() const
+	{
+		return VAO;
+	}
+
+	void release()
+	{
+		glDeleteVertexArrays(1, &VAO);
+		glDeleteBuffers(1, &VBO);
+		glDeleteBuffers(1, &EBO);
+		VAO = VBO = EBO = 0;
+	}
+
+private:
+	struct Vertex
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 texCoords;
+	};
+
+	// the cubes of a range are order[first] to order[end - 1]
+	struct RangeCubes
+	{
+		unsigned int first;
+		unsigned int end;
+	};
+
+	unsigned int VAO;
+	unsigned int VBO;
+	unsigned int EBO;
+
+	// split order[first, end), cubes of one material, into pieces of at most RANGE_CUBES nearby cubes
+	static void split(const StaticScene &scene, std::vector<unsigned int> &order, unsigned int first, unsigned int end, std::vector<RangeCubes> &pieces)
+	{
+		if(first == end)
+			return;
+		if(end - first <= RANGE_CUBES)
+		{
+			RangeCubes piece;
+			piece.first = first;
+			piece.end = end;
+			pieces.push_back(piece);
+			return;
+		}
+
+		glm::vec3 low(scene.models[order[first]][3]), high = low;
+		for(unsigned int i = first + 1; i < end; i++)
+		{
+			glm::vec3 position(scene.models[order[i]][3]);
+			low = glm::min(low, position);
+			high = glm::max(high, position);
+		}
+		glm::vec3 spread = high - low;
+		int axis = 0;
+		if(spread.y > spread.x)
+			axis = 1;
+		if(spread.z > spread[axis])
+			axis = 2;
+
+		unsigned int middle = first + (end - first) / 2;
+		const std::vector<glm::mat4> &models = scene.models;
+		std::nth_element(order.begin() + first, order.begin() + middle, order.begin() + end,
+			[&](unsigned int a, unsigned int b) { return models[a][3][axis] < models[b][3][axis]; });
+		split(scene, order, first, middle, pieces);
+		split(scene, order, middle, end, pieces);
+	}
+
+	void upload(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices)
+	{
+		if(VAO == 0)
+		{
+			glGenVertexArrays(1, &VAO);
+			glGenBuffers(1, &VBO);
+			glGenBuffers(1, &EBO);
+		}
+		glBindVertexArray(VAO);
+
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.empty() ? NULL : &vertices[0], GL_STATIC_DRAW);
+		// the element buffer binding is part of the VAO
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.empty() ? NULL : &indices[0], GL_STATIC_DRAW);
+
+		// POSITION INDEX
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+		glEnableVertexAttribArray(0);
+		// NORMAL INDEX
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(3 * sizeof(float)));
+		glEnableVertexAttribArray(1);
+		// TEXTURE INDEX
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(6 * sizeof(float)));
+		glEnableVertexAttribArray(2);
+
+		glBindVertexArray(0);
+	}
+};
+#endif
@@ -0,0 +1,240 @@
+// BOUNDING VOLUME HIERARCHY OVER BOXES THAT NEVER MOVE (THE CUBES OF THE STATIC SCENE)
+// BUILT ONCE BY SPLITTING THE BOXES IN HALF ALONG THE LONGEST AXIS UNTIL A FEW ARE LEFT, THEN ANSWERS
+// "WHICH BOXES ARE IN THE VIEW FRUSTUM?" AND "WHAT DOES THIS RAY HIT FIRST?" WITHOUT LOOKING AT EVERY BOX
+// NOTHING CHANGES AFTER build(), SO ANY NUMBER OF THREADS CAN QUERY IT AT ONCE
+
+#ifndef STATIC_BVH_H
+#define STATIC_BVH_H
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <stddef.h>
+#include <vector>
+
+#include "Frustum.h"
+
+class StaticBvh
+{
+public:
+	// boxes that hold at most this many items are not split any further
+	static const unsigned int LEAF_SIZE = 4;
+
+	// build over the axis-aligned boxes given by their centres and half sizes, item i of a query is box i
+	void build(const std::vector<glm::vec3> &centers, const std::vector<glm::vec3> &extents)
+	{
+		nodes.clear();
+		order.resize(centers.size());
+		for(size_t i = 0; i < order.size(); i++)
+			order[i] = i;
+		this->centers = centers;
+		this->extents = extents;
+		if(order.empty())
+			return;
+
+		// a tree with leaves of 1 to LEAF_SIZE items has fewer than 2 * items nodes
+		nodes.reserve(2 * order.size());
+		buildNode(0, order.size());
+
+		// store the boxes in tree order, so a leaf reads its items from one stretch of memory
+		sortedCenters.resize(order.size());
+		sortedExtents.resize(order.size());
+		for(size_t i = 0; i < order.size(); i++)
+		{
+			sortedCenters[i] = centers[order[i]];
+			sortedExtents[i] = extents[order[i]];
+		}
+		std::vector<glm::vec3>().swap(this->centers);
+		std::vector<glm::vec3>().swap(this->extents);
+	}
+
+	size_t size() const
+	{
+		return order.size();
+	}
+
+	// call visit(item) for every box at least partly inside the frustum
+	template<class Visit>
+	void queryFrustum(const Frustum &frustum, const Visit &visit) const
+	{
+		if(nodes.empty())
+			return;
+		unsigned int stack[STACK_SIZE];
+		unsigned int top = 0;
+		stack[top++] = 0;
+		while(top > 0)
+		{
+			const Node &node = nodes[stack[--top]];
+			FrustumTest test = frustum.classifyBox(node.center, node.extent);
+			if(test == FRUSTUM_OUTSIDE)
+				continue;
+
+			unsigned int end = node.first + node.count;
+			if(test == FRUSTUM_INSIDE)
+			{
+				// everything below is inside too
+				for(unsigned int i = node.first; i < end; i++)
+					visit(order[i]);
+			}
+			else if(node.second == 0)
+			{
+				for(unsigned int i = node.first; i < end; i++)
+				{
+					if(frustum.containsBox(sortedCenters[i], sortedExtents[i]))
+						visit(order[i]);
+				}
+			}
+			else
+			{
+				stack[top++] = node.second;
+				stack[top++] = &node - &nodes[0] + 1;
+			}
+		}
+	}
+
+	// the nearest box the ray from origin along direction (unit length) hits within maxDistance,
+	// returns false if there is none, otherwise sets distance and item (a ray starting inside a box hits it at 0)
+	bool raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, float &distance, unsigned int &item) const
+	{
+		if(nodes.empty())
+			return false;
+		// 1 / 0 gives infinity, which the slab test below handles
+		glm::vec3 inverse(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+		float nearest = maxDistance;
+		bool hit = false;
+
+		unsigned int stack[STACK_SIZE];
+		unsigned int top = 0;
+		float enter;
+		if(rayBox(origin, inverse, nodes[0].center, nodes[0].extent, nearest, enter))
+			stack[top++] = 0;
+		while(top > 0)
+		{
+			unsigned int index = stack[--top];
+			const Node &node = nodes[index];
+			// a nearer hit was found since this node was pushed
+			if(!rayBox(origin, inverse, node.center, node.extent, nearest, enter))
+				continue;
+
+			if(node.second == 0)
+			{
+				unsigned int end = node.first + node.count;
+				for(unsigned int i = node.first; i < end; i++)
+				{
+					if(rayBox(origin, inverse, sortedCenters[i], sortedExtents[i], nearest, enter))
+					{
+						nearest = enter;
+						item = order[i];
+						hit = true;
+					}
+				}
+				continue;
+			}
+
+			// visit the nearer child first, its hits prune the farther one
+			unsigned int first = index + 1, second = node.second;
+			float firstEnter, secondEnter;
+			bool firstHit = rayBox(origin, inverse, nodes[first].center, nodes[first].extent, nearest, firstEnter);
+			bool secondHit = rayBox(origin, inverse, nodes[second].center, nodes[second].extent, nearest, secondEnter);
+			if(firstHit && secondHit && secondEnter < firstEnter)
+			{
+				std::swap(first, second);
+				std::swap(firstHit, secondHit);
+			}
+			if(secondHit)
+				stack[top++] = second;
+			if(firstHit)
+				stack[top++] = first;
+		}
+
+		if(hit)
+			distance = nearest;
+		return hit;
+	}
+
+	// slab test: does the ray enter the box before limit? enter is where, 0 if it starts inside
+	// inverse is 1 / direction per axis
+	static bool rayBox(const glm::vec3 &origin, const glm::vec3 &inverse, const glm::vec3 &center, const glm::vec3 &extent, float limit, float &enter)
+	{
+		glm::vec3 t0 = (center - extent - origin) * inverse;
+		glm::vec3 t1 = (center + extent - origin) * inverse;
+		glm::vec3 entry = glm::min(t0, t1), leave = glm::max(t0, t1);
+		enter = std::max(std::max(entry.x, entry.y), std::max(entry.z, 0.0f));
+		float exit = std::min(std::min(leave.x, leave.y), leave.z);
+		return enter <= exit && enter < limit;
+	}
+
+private:
+	// halving the items at every level keeps the tree about log2(items / LEAF_SIZE) deep,
+	// and a traversal holds at most one pending node per level plus the current pair
+	static const unsigned int STACK_SIZE = 128;
+
+	struct Node
+	{
+		glm::vec3 center;
+		glm::vec3 extent;
+		// the items below this node are order[first] to order[first + count - 1]
+		unsigned int first;
+		unsigned int count;
+		// the first child directly follows its parent, this is the second one, 0 for a leaf
+		unsigned int second;
+	};
+
+	// add the node holding order[first, end) and everything below it, depth first
+	unsigned int buildNode(unsigned int first, unsigned int end)
+	{
+		unsigned int index = nodes.size();
+		nodes.push_back(Node());
+
+		// bounds of the boxes, and of their centres to pick the split axis
+		glm::vec3 low = centers[order[first]] - extents[order[first]];
+		glm::vec3 high = centers[order[first]] + extents[order[first]];
+		glm::vec3 centerLow = centers[order[first]], centerHigh = centers[order[first]];
+		for(unsigned int i = first + 1; i < end; i++)
+		{
+			const glm::vec3 &center = centers[order[i]];
+			low = glm::min(low, center - extents[order[i]]);
+			high = glm::max(high, center + extents[order[i]]);
+			centerLow = glm::min(centerLow, center);
+			centerHigh = glm::max(centerHigh, center);
+		}
+
+		Node node;
+		node.center = 0.5f * (low + high);
+		node.extent = 0.5f * (high - low);
+		node.first = first;
+		node.count = end - first;
+		node.second = 0;
+
+		if(node.count > LEAF_SIZE)
+		{
+			glm::vec3 spread = centerHigh - centerLow;
+			int axis = 0;
+			if(spread.y > spread.x)
+				axis = 1;
+			if(spread.z > spread[axis])
+				axis = 2;
+
+			// the median along that axis, so both halves hold the same number of items
+			unsigned int middle = first + node.count / 2;
+			const std::vector<glm::vec3> &c = centers;
+			std::nth_element(order.begin() + first, order.begin() + middle, order.begin() + end,
+				[&](unsigned int a, unsigned int b) { return c[a][axis] < c[b][axis]; });
+
+			buildNode(first, middle);
+			node.second = buildNode(middle, end);
+		}
+		nodes[index] = node;
+		return index;
+	}
+
+	std::vector<Node> nodes;
+	// item of every position in tree order
+	std::vector<unsigned int> order;
+	// boxes in item order while building, in tree order once built
+	std::vector<glm::vec3> centers;
+	std::vector<glm::vec3> extents;
+	std::vector<glm::vec3> sortedCenters;
+	std::vector<glm::vec3> sortedExtents;
+};
+#endif
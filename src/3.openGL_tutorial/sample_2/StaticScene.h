@@ -0,0 +1,103 @@
+// HOLDS THE FINAL MODEL AND NORMAL MATRICES OF EVERY CUBE THAT NEVER MOVES (SKY, TREES, PORTAL, GROUND)
+// THEY ARE BAKED ONCE AT STARTUP AND STORED CONTIGUOUSLY, GROUPED BY MATERIAL,
+// WITH A BOUNDING VOLUME HIERARCHY OVER THEM FOR FRUSTUM CULLING AND RAY QUERIES
+
+#ifndef STATIC_SCENE_H
+#define STATIC_SCENE_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "Frustum.h"
+#include "NormalMatrix.h"
+#include "StaticBvh.h"
+
+// the texture of a static cube is picked every frame, since horror mode swaps most of them
+enum StaticMaterial {
+	STATIC_SKY,
+	STATIC_BARS,
+	STATIC_WOOD,
+	STATIC_LEAF,
+	STATIC_STRUCTURE,
+	STATIC_PORTAL,
+	STATIC_GROUND,
+	STATIC_MATERIAL_COUNT
+};
+
+// how far the leaves bob up and down in horror mode, their bounds are grown by this much
+const float STATIC_LEAF_BOB = 0.1f;
+
+class StaticScene
+{
+public:
+	// matrices of every static cube, the cubes of one material sit next to each other
+	std::vector<glm::mat4> models;
+	std::vector<glm::mat3> normals;
+	// material of every cube
+	std::vector<unsigned char> materials;
+	// over every cube, item i of a query is cube i
+	StaticBvh bvh;
+
+	StaticScene()
+	{
+		for(unsigned int i = 0; i < STATIC_MATERIAL_COUNT; i++)
+			firsts[i] = counts[i] = 0;
+	}
+
+	// record a cube while baking
+	void add(StaticMaterial material, const glm::mat4 &model)
+	{
+		pending[material].push_back(model);
+	}
+
+	// lay the recorded cubes out by material and compute their normal matrices
+	void finish()
+	{
+		models.clear();
+		normals.clear();
+		materials.clear();
+		for(unsigned int i = 0; i < STATIC_MATERIAL_COUNT; i++)
+		{
+			firsts[i] = models.size();
+			counts[i] = pending[i].size();
+			for(size_t j = 0; j < pending[i].size(); j++)
+			{
+				models.push_back(pending[i][j]);
+				materials.push_back(i);
+			}
+			pending[i].clear();
+		}
+
+		normals.resize(models.size());
+		if(!models.empty())
+			normalMatrices(&models[0], &normals[0], models.size());
+
+		std::vector<glm::vec3> centers(models.size()), extents(models.size());
+		for(size_t i = 0; i < models.size(); i++)
+		{
+			Frustum::cubeBounds(models[i], centers[i], extents[i]);
+			if(materials[i] == STATIC_LEAF)
+				extents[i].y += STATIC_LEAF_BOB;
+		}
+		bvh.build(centers, extents);
+	}
+
+	// index of the first cube of a material
+	unsigned int first(StaticMaterial material) const
+	{
+		return firsts[material];
+	}
+
+	// number of cubes of a material
+	unsigned int count(StaticMaterial material) const
+	{
+		return counts[material];
+	}
+
+private:
+	std::vector<glm::mat4> pending[STATIC_MATERIAL_COUNT];
+	unsigned int firsts[STATIC_MATERIAL_COUNT];
+	unsigned int counts[STATIC_MATERIAL_COUNT];
+};
+#endif
@@ -0,0 +1,266 @@
+// AN ON-DISK CACHE OF THE GAME'S TEXTURES, COMPRESSED TO DXT1 (NO ALPHA) OR DXT5 (WITH ALPHA) THE SAME WAY AS THE BUNDLED
+// image_DXT CODE (SEE DxtCompressor.h): THE FIRST RUN BOX FILTERS EVERY DECODED IMAGE DOWN TO A FULL MIPMAP CHAIN (SEE MipmapChain.h), COMPRESSES EVERY LEVEL
+// AND SAVES THEM AS ONE DDS FILE, LATER RUNS READ THAT FILE AND HAND THE BLOCKS TO glCompressedTexImage2D AS THEY ARE
+// (NO JPEG/PNG DECODE, NO glGenerateMipmap, AND 4 TO 8 TIMES LESS TEXTURE MEMORY THAN RGBA)
+//
+// AN ENTRY IS NAMED AFTER THE SOURCE FILE PLUS A HASH OF ITS PATH, MODIFICATION TIME, SIZE AND CACHE_VERSION,
+// SO EDITING A TEXTURE (OR CHANGING THE ENCODER) SIMPLY MISSES AND WRITES A NEW ENTRY
+
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <glad/glad.h>
+#include <image_DXT.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <string>
+#include <vector>
+
+#include "DxtCompressor.h"
+#include "JobSystem.h"
+#include "MipmapChain.h"
+
+// EXT_texture_compression_s3tc, not part of core OpenGL so glad does not define them
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+// a texture as DXT blocks, every mipmap level from the full size down to 1x1
+struct CompressedTexture
+{
+	struct Level
+	{
+		int width;
+		int height;
+		// the level's blocks are blocks[offset] to blocks[offset + size - 1]
+		size_t offset;
+		size_t size;
+	};
+
+	// GL_COMPRESSED_RGB_S3TC_DXT1_EXT or GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+	GLenum format;
+	std::vector<Level> levels;
+	std::vector<unsigned char> blocks;
+
+	CompressedTexture() : format(0) {}
+
+	void clear()
+	{
+		format = 0;
+		levels.clear();
+		blocks.clear();
+	}
+};
+
+class TextureCache
+{
+public:
+	// part of every entry's name, raise it when the compressed blocks change for the same source file
+	static const uint32_t CACHE_VERSION = 1;
+
+	// entries are stored in directory, which must already exist (nothing is written otherwise)
+	TextureCache(const std::string &directory) : directory(directory) {}
+
+	// can the current OpenGL context sample DXT1/DXT5 textures? needs a context
+	static bool supported()
+	{
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for(GLint i = 0; i < count; i++)
+		{
+			const char *name = (const char *)glGetStringi(GL_EXTENSIONS, i);
+			if(name && !strcmp(name, "GL_EXT_texture_compression_s3tc"))
+				return true;
+		}
+		return false;
+	}
+
+	// read the entry of a source file, false if there is none (or it can't be used)
+	bool load(const std::string &source, CompressedTexture &texture) const
+	{
+		std::string path = entryPath(source);
+		if(path.empty())
+			return false;
+		FILE *file = fopen(path.c_str(), "rb");
+		if(!file)
+			return false;
+
+		DDS_header header;
+		bool valid = fread(&header, sizeof(header), 1, file) == 1 && readHeader(header, texture);
+		if(valid)
+		{
+			texture.blocks.resize(texture.levels.back().offset + texture.levels.back().size);
+			valid = fread(&texture.blocks[0], 1, texture.blocks.size(), file) == texture.blocks.size();
+		}
+		fclose(file);
+		if(!valid)
+			texture.clear();
+		return valid;
+	}
+
+	// write the entry of a source file, through a temporary file so a reader never sees half of it
+	bool store(const std::string &source, const CompressedTexture &texture) const
+	{
+		std::string path = entryPath(source);
+		if(path.empty() || texture.levels.empty())
+			return false;
+		std::string temporary = path + ".tmp";
+		FILE *file = fopen(temporary.c_str(), "wb");
+		if(!file)
+			return false;
+
+		DDS_header header;
+		writeHeader(texture, header);
+		bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+			fwrite(&texture.blocks[0], 1, texture.blocks.size(), file) == texture.blocks.size();
+		written = fclose(file) == 0 && written;
+		if(written)
+		{
+			remove(path.c_str());
+			written = rename(temporary.c_str(), path.c_str()) == 0;
+		}
+		if(!written)
+			remove(temporary.c_str());
+		return written;
+	}
+
+	// box filter the pixels (tightly packed rows, as stb_image returns them) down to 1x1 and compress every level,
+	// only RGB and RGBA images can be compressed; jobs (if given) share out the blocks of every level
+	static bool compress(const unsigned char *pixels, int width, int height, int components, CompressedTexture &texture, JobSystem *jobs = NULL)
+	{
+		texture.clear();
+		if(!pixels || width < 1 || height < 1 || (components != 3 && components != 4))
+			return false;
+		texture.format = components == 4 ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+
+		MipmapChain mipmaps;
+		buildMipmaps(pixels, width, height, components, mipmaps);
+		for(size_t i = 0; i <= mipmaps.levels.size(); i++)
+		{
+			CompressedTexture::Level entry;
+			entry.width = i == 0 ? width : mipmaps.levels[i - 1].width;
+			entry.height = i == 0 ? height : mipmaps.levels[i - 1].height;
+			entry.offset = texture.blocks.size();
+			entry.size = dxtSize(entry.width, entry.height, components == 4);
+			texture.levels.push_back(entry);
+			texture.blocks.resize(entry.offset + entry.size);
+			compressDxt(i == 0 ? pixels : mipmaps.levelPixels(i - 1), entry.width, entry.height, components, components == 4,
+				&texture.blocks[entry.offset], jobs);
+		}
+		return true;
+	}
+
+	// bytes of a level with DXT blocks of blockBytes
+	static size_t levelSize(int width, int height, int blockBytes)
+	{
+		return (size_t)((width + 3) / 4) * ((height + 3) / 4) * blockBytes;
+	}
+
+private:
+	std::string directory;
+
+	// name of the entry of a source file, empty if the file can't be found
+	std::string entryPath(const std::string &source) const
+	{
+		struct stat status;
+		if(stat(source.c_str(), &status) != 0)
+			return std::string();
+
+		// FNV-1a over the path, modification time, size and version
+		uint64_t hash = 14695981039346656037ULL;
+		hashBytes(hash, source.data(), source.size());
+		int64_t modified = (int64_t)status.st_mtime, bytes = (int64_t)status.st_size;
+		uint32_t version = CACHE_VERSION;
+		hashBytes(hash, &modified, sizeof(modified));
+		hashBytes(hash, &bytes, sizeof(bytes));
+		hashBytes(hash, &version, sizeof(version));
+
+		size_t slash = source.find_last_of("/\\");
+		char key[24];
+		snprintf(key, sizeof(key), ".%016llx.dds", (unsigned long long)hash);
+		return directory + "/" + (slash == std::string::npos ? source : source.substr(slash + 1)) + key;
+	}
+
+	static void hashBytes(uint64_t &hash, const void *data, size_t size)
+	{
+		const unsigned char *bytes = (const unsigned char *)data;
+		for(size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ULL;
+		}
+	}
+
+	static uint32_t fourCC(char a, char b, char c, char d)
+	{
+		return (uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24);
+	}
+
+	static void writeHeader(const CompressedTexture &texture, DDS_header &header)
+	{
+		memset(&header, 0, sizeof(header));
+		header.dwMagic = fourCC('D', 'D', 'S', ' ');
+		header.dwSize = 124;
+		header.dwFlags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_LINEARSIZE | DDSD_MIPMAPCOUNT;
+		header.dwWidth = texture.levels[0].width;
+		header.dwHeight = texture.levels[0].height;
+		header.dwPitchOrLinearSize = texture.levels[0].size;
+		header.dwMipMapCount = texture.levels.size();
+		header.sPixelFormat.dwSize = 32;
+		header.sPixelFormat.dwFlags = DDPF_FOURCC;
+		header.sPixelFormat.dwFourCC = texture.format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT ? fourCC('D', 'X', 'T', '5') : fourCC('D', 'X', 'T', '1');
+		header.sCaps.dwCaps1 = DDSCAPS_TEXTURE | DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+	}
+
+	// the levels of a header written by writeHeader(), false for anything else
+	static bool readHeader(const DDS_header &header, CompressedTexture &texture)
+	{
+		if(header.dwMagic != fourCC('D', 'D', 'S', ' ') || header.dwSize != 124 || header.sPixelFormat.dwFlags != DDPF_FOURCC)
+			return false;
+		int blockBytes;
+		if(header.sPixelFormat.dwFourCC == fourCC('D', 'X', 'T', '1'))
+		{
+			texture.format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+			blockBytes = 8;
+		}
+		else if(header.sPixelFormat.dwFourCC == fourCC('D', 'X', 'T', '5'))
+		{
+			texture.format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			blockBytes = 16;
+		}
+		else
+			return false;
+
+		int width = header.dwWidth, height = header.dwHeight;
+		if(width < 1 || height < 1 || width > 16384 || height > 16384)
+			return false;
+		texture.levels.clear();
+		size_t offset = 0;
+		for(unsigned int i = 0; i < header.dwMipMapCount; i++)
+		{
+			// a chain goes on past 1x1
+			if(i > 0 && texture.levels.back().width == 1 && texture.levels.back().height == 1)
+				return false;
+			CompressedTexture::Level level;
+			level.width = width;
+			level.height = height;
+			level.offset = offset;
+			level.size = levelSize(width, height, blockBytes);
+			texture.levels.push_back(level);
+			offset += level.size;
+			width = width > 1 ? width / 2 : 1;
+			height = height > 1 ? height / 2 : 1;
+		}
+		// a complete chain ends at 1x1
+		return !texture.levels.empty() && texture.levels.back().width == 1 && texture.levels.back().height == 1;
+	}
+};
+#endif
@@ -0,0 +1,263 @@
+// LOADS THE TEXTURES OF THE GAME AT STARTUP: EVERY IMAGE FILE IS DECODED AT THE SAME TIME ON A POOL OF THREADS,
+// THEN UPLOADED TO OPENGL ONE AFTER THE OTHER ON THE THREAD THAT OWNS THE CONTEXT (OPENGL CALLS CAN'T BE MADE ANYWHERE ELSE)
+// BOTH STEPS ARE TIMED PER FILE, SO THE STARTUP COST OF EVERY TEXTURE CAN BE PRINTED
+// WITH A TextureCache, A FILE IS READ AS COMPRESSED BLOCKS FROM THE CACHE INSTEAD, OR COMPRESSED AND ADDED TO IT (SEE TextureCache.h)
+
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include <glad/glad.h>
+#include <stb_image.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "JobSystem.h"
+#include "TextureCache.h"
+
+class TextureLoader
+{
+public:
+	TextureLoader() : cache(NULL), threads(0), decodeWallMs(0.0) {}
+
+	~TextureLoader()
+	{
+		// images that were decoded but never uploaded
+		for(size_t i = 0; i < images.size(); i++)
+			stbi_image_free(images[i].data);
+	}
+
+	// queue a file, upload() stores the name of its texture in *texture
+	void add(const std::string &path, unsigned int *texture)
+	{
+		Image image;
+		image.path = path;
+		image.texture = texture;
+		image.data = NULL;
+		image.width = image.height = image.components = 0;
+		image.decoded = false;
+		image.cacheHit = image.cacheAdded = false;
+		image.decodeMs = image.uploadMs = 0.0;
+		image.bytes = 0;
+		images.push_back(image);
+	}
+
+	// read and write compressed textures through cache from now on, NULL to always decode the files
+	void setCache(const TextureCache *cache)
+	{
+		this->cache = cache;
+	}
+
+	// decode every queued file, one file per job, spread over the threads of jobs (the calling thread joins in)
+	void decode(JobSystem &jobs)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		threads = jobs.threadCount();
+
+		// stb_image fills its PNG decompression tables the first time it needs them,
+		// so one PNG is decoded on this thread (one that is not in the cache) before the others can race to do it
+		for(size_t i = 0; i < images.size(); i++)
+		{
+			if(images[i].path.size() >= 4 && images[i].path.compare(images[i].path.size() - 4, 4, ".png") == 0)
+			{
+				decodeImage(images[i], jobs);
+				if(!images[i].cacheHit)
+					break;
+			}
+		}
+		jobs.parallelFor(0, images.size(), 1, [this, &jobs](size_t first, size_t last)
+		{
+			for(size_t i = first; i < last; i++)
+			{
+				if(!images[i].decoded)
+					decodeImage(images[i], jobs);
+			}
+		});
+
+		decodeWallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	/*
+		SOURCE(s):
+		https://learnopengl.com/code_viewer_gh.php?code=src/2.lighting/4.2.lighting_maps_specular_map/lighting_maps_specular.cpp
+	*/
+	// create a texture for every decoded file and free its pixels, must run on the thread owning the OpenGL context
+	// a file that failed to decode still gets an (empty) texture, as before, a compressed one comes with its mipmaps
+	void upload()
+	{
+		// stb_image rows are packed tightly, an RGB row of an odd width is not padded to 4 bytes as GL expects by default
+		// (reading past the end of the pixels only crashed once they were allocated by a worker thread)
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		for(size_t i = 0; i < images.size(); i++)
+		{
+			Image &image = images[i];
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+			unsigned int textureID;
+			glGenTextures(1, &textureID);
+			*image.texture = textureID;
+			if(!image.compressed.levels.empty())
+			{
+				glBindTexture(GL_TEXTURE_2D, textureID);
+				const CompressedTexture &compressed = image.compressed;
+				for(size_t level = 0; level < compressed.levels.size(); level++)
+				{
+					const CompressedTexture::Level &mip = compressed.levels[level];
+					glCompressedTexImage2D(GL_TEXTURE_2D, level, compressed.format, mip.width, mip.height, 0, mip.size, &compressed.blocks[mip.offset]);
+				}
+				image.bytes = compressed.blocks.size();
+
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+				image.compressed.clear();
+			}
+			else if(image.data)
+			{
+				GLenum format = GL_RGB;
+				if(image.components == 1)
+					format = GL_RED;
+				else if(image.components == 3)
+					format = GL_RGB;
+				else if(image.components == 4)
+					format = GL_RGBA;
+
+				glBindTexture(GL_TEXTURE_2D, textureID);
+				glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.data);
+				glGenerateMipmap(GL_TEXTURE_2D);
+				image.bytes = rawBytes(image.width, image.height, image.components);
+
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+				stbi_image_free(image.data);
+				image.data = NULL;
+			}
+			else
+				std::cout << "Texture failed to load at path: " << image.path << std::endl;
+
+			image.uploadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	}
+
+	// decode and upload time and texture memory of every file, then the totals
+	void printTimes(std::ostream &out) const
+	{
+		double decodeSum = 0.0, uploadSum = 0.0;
+		size_t bytes = 0;
+		for(size_t i = 0; i < images.size(); i++)
+		{
+			out << "TEXTURE " << fileName(images[i].path) << ": decode " << images[i].decodeMs << " ms, upload " << images[i].uploadMs << " ms, "
+				<< images[i].bytes / 1024 << " KB" << cacheState(images[i]) << std::endl;
+			decodeSum += images[i].decodeMs;
+			uploadSum += images[i].uploadMs;
+			bytes += images[i].bytes;
+		}
+		out << "TEXTURES: " << images.size() << " files decoded in " << decodeWallMs << " ms on " << threads << " threads ("
+			<< decodeSum << " ms one after the other), uploaded in " << uploadSum << " ms, " << bytes / 1024 << " KB" << std::endl;
+	}
+
+	// the same as a "textures" member of a JSON object, one tab deep
+	void writeJson(std::ostream &out) const
+	{
+		double uploadSum = 0.0;
+		size_t bytes = 0;
+		for(size_t i = 0; i < images.size(); i++)
+		{
+			uploadSum += images[i].uploadMs;
+			bytes += images[i].bytes;
+		}
+
+		out << "\t\"textures\": { \"threads\": " << threads << ", \"cache\": " << (cache ? "true" : "false") << ", \"decodeMs\": " << decodeWallMs
+			<< ", \"uploadMs\": " << uploadSum << ", \"bytes\": " << bytes << ", \"files\": [\n";
+		for(size_t i = 0; i < images.size(); i++)
+		{
+			out << "\t\t{ \"file\": \"" << fileName(images[i].path) << "\", \"decodeMs\": " << images[i].decodeMs
+				<< ", \"uploadMs\": " << images[i].uploadMs << ", \"bytes\": " << images[i].bytes;
+			if(cache)
+				out << ", \"cacheHit\": " << (images[i].cacheHit ? "true" : "false");
+			out << " }" << (i + 1 < images.size() ? "," : "") << "\n";
+		}
+		out << "\t] }";
+	}
+
+private:
+	struct Image
+	{
+		std::string path;
+		// where upload() stores the texture name
+		unsigned int *texture;
+		// decoded pixels, NULL if decoding failed or once uploaded
+		unsigned char *data;
+		int width;
+		int height;
+		int components;
+		// the blocks of every mipmap level when the file went through the cache, empty once uploaded
+		CompressedTexture compressed;
+		bool decoded;
+		// the blocks were read from the cache, the file itself was never decoded
+		bool cacheHit;
+		// the file was decoded and its blocks written to the cache
+		bool cacheAdded;
+		double decodeMs;
+		double uploadMs;
+		// texture memory of the uploaded texture with its mipmaps
+		size_t bytes;
+	};
+
+	std::vector<Image> images;
+	const TextureCache *cache;
+	// threads the last decode() ran on, including the calling one
+	unsigned int threads;
+	// from the start to the end of the last decode()
+	double decodeWallMs;
+
+	// with a cache this also reads the compressed blocks, or compresses the pixels (sharing out the blocks over jobs) and stores them
+	void decodeImage(Image &image, JobSystem &jobs) const
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		if(cache && cache->load(image.path, image.compressed))
+			image.cacheHit = true;
+		else
+		{
+			image.data = stbi_load(image.path.c_str(), &image.width, &image.height, &image.components, 0);
+			if(cache && TextureCache::compress(image.data, image.width, image.height, image.components, image.compressed, &jobs))
+			{
+				image.cacheAdded = cache->store(image.path, image.compressed);
+				stbi_image_free(image.data);
+				image.data = NULL;
+			}
+		}
+		image.decoded = true;
+		image.decodeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// an RGB(A) texture with its mipmaps takes about a third more than its first level
+	static size_t rawBytes(int width, int height, int components)
+	{
+		return (size_t)width * height * components * 4 / 3;
+	}
+
+	const char *cacheState(const Image &image) const
+	{
+		if(!cache)
+			return "";
+		if(image.cacheHit)
+			return " (cached)";
+		return image.cacheAdded ? " (added to the cache)" : " (not cached)";
+	}
+
+	static std::string fileName(const std::string &path)
+	{
+		size_t slash = path.find_last_of("/\\");
+		return slash == std::string::npos ? path : path.substr(slash + 1);
+	}
+};
+#endif
@@ -0,0 +1,105 @@
+// TIMES SETTING THE "model" MATRIX OF THE LIGHTING SHADER ON THE HEADLESS CONTEXT THREE WAYS: LOOKING THE LOCATION UP WITH
+// glGetUniformLocation ON EVERY CALL (WHAT Shader.h USED TO DO), THE NAME SETTER READING THE CACHED LOCATION, AND THE SETTER
+// TAKING A LOCATION RESOLVED ONCE, AND WRITES THE CALLS PER SECOND OF EACH AS JSON
+// ONLY USED BY THE HEADLESS BENCHMARK BUILD (SAMPLE_2_BENCHMARK), RUN WITH "--uniforms"
+
+#ifndef UNIFORM_BENCHMARK_H
+#define UNIFORM_BENCHMARK_H
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <iostream>
+#include <string>
+
+#include "Benchmark.h"
+#include "HeadlessContext.h"
+#include "Shader.h"
+
+class UniformBenchmark
+{
+public:
+	UniformBenchmark(const BenchmarkOptions &options) : options(options) {}
+
+	bool run()
+	{
+		HeadlessContext headless;
+		if(!headless.create())
+			return false;
+		if(!gladLoadGLLoader((GLADloadproc)HeadlessContext::procAddress))
+		{
+			std::cout << "Failed to initialize GLAD" << std::endl;
+			headless.release();
+			return false;
+		}
+
+		bool ran = writeBenchmarkReport(options, [this](std::ostream &out)
+		{
+			return run(out);
+		});
+		headless.release();
+		return ran;
+	}
+
+private:
+	enum Setter
+	{
+		LOOKUP,
+		CACHED_NAME,
+		HANDLE
+	};
+
+	bool run(std::ostream &out) const
+	{
+		const unsigned int calls = 1000000;
+		const unsigned int repeats = 3;
+		const char *names[] = { "lookup", "cachedName", "handle" };
+
+		Shader shader("lightingVS.vs", "lightingFS.fs");
+		shader.use();
+		if(shader.getUniformLocation("model") == -1)
+		{
+			std::cout << "Error finding the model uniform of the lighting shader" << std::endl;
+			return false;
+		}
+
+		out << "{\n"
+			<< "\t\"calls\": " << calls << ",\n"
+			<< "\t\"setters\": [\n";
+		writeSpeedups(out, "setter", "callsPerSecond", names, HANDLE + 1, calls, [&](int setter)
+		{
+			glFinish();
+			return bestMilliseconds(repeats, [&]() { set(shader, (Setter)setter, calls); });
+		}, [](std::ostream &, int) {});
+		out << "\t],\n"
+			<< "\t\"glError\": " << glGetError() << "\n"
+			<< "}" << std::endl;
+		return true;
+	}
+
+	// set calls matrices one way, each one a little different so nothing can be skipped, and wait until OpenGL is done
+	static void set(const Shader &shader, Setter setter, unsigned int calls)
+	{
+		glm::mat4 model(1.0f);
+		int location = shader.getUniformLocation("model");
+		for(unsigned int i = 0; i < calls; i++)
+		{
+			model[3][0] = (float)i;
+			if(setter == LOOKUP)
+			{
+				// the setter before the locations were cached
+				const std::string name("model");
+				glUniformMatrix4fv(glGetUniformLocation(shader.ID, name.c_str()), 1, GL_FALSE, &model[0][0]);
+			}
+			else if(setter == CACHED_NAME)
+				shader.setMat4("model", model);
+			else
+				shader.setMat4(location, model);
+		}
+		glFinish();
+	}
+
+	BenchmarkOptions options;
+};
+#endif
@@ -0,0 +1,91 @@
+// RUNS World::update() ON A WORKER THREAD, SO THE NEXT FRAME IS SIMULATED WHILE THE MAIN THREAD
+// IS STILL SUBMITTING THE CURRENT ONE TO OPENGL
+// THE MAIN THREAD MUST NOT TOUCH THE WORLD BETWEEN start() AND finish(), IT DRAWS THE PREVIOUS SNAPSHOT INSTEAD
+
+#ifndef UPDATE_THREAD_H
+#define UPDATE_THREAD_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "InputState.h"
+#include "RenderSnapshot.h"
+#include "World.h"
+
+class UpdateThread
+{
+public:
+	UpdateThread(World &world) : world(world), frameTime(0.0f), pending(false), done(true), stopping(false)
+	{
+		worker = std::thread(&UpdateThread::run, this);
+	}
+
+	~UpdateThread()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		worker.join();
+	}
+
+	// begin updating the world with this frame's input, returns straight away
+	void start(const InputState &input, float frameTime)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->input = input;
+		this->frameTime = frameTime;
+		pending = true;
+		done = false;
+		wake.notify_all();
+	}
+
+	// wait for the update begun by start() and swap what it produced into frame,
+	// the old contents of frame become the buffer the next update writes into
+	void finish(RenderSnapshot &frame)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		while(!done)
+			wake.wait(lock);
+		std::swap(frame, snapshot);
+	}
+
+private:
+	void run()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		while(true)
+		{
+			while(!pending && !stopping)
+				wake.wait(lock);
+			if(stopping)
+				return;
+			pending = false;
+
+			// the main thread only waits while the world is updated, so it can be done unlocked
+			lock.unlock();
+			world.update(input, frameTime, snapshot);
+			lock.lock();
+
+			done = true;
+			wake.notify_all();
+		}
+	}
+
+	World &world;
+	std::thread worker;
+	std::mutex mutex;
+	std::condition_variable wake;
+	// the job handed over by start()
+	InputState input;
+	float frameTime;
+	// result of the last update
+	RenderSnapshot snapshot;
+	bool pending;
+	bool done;
+	bool stopping;
+};
+#endif
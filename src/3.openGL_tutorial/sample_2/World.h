@@ -0,0 +1,851 @@
+// OWNS EVERYTHING THE GAME SIMULATES: THE PLAYER, THE LAMP, SVEN, THE CREATURES AND THE GAME RULES
+// update() RUNS THE FIXED SIMULATION TICKS OF A FRAME AND HANDS THE RENDERER A RenderSnapshot,
+// THE RENDERER NEVER READS THE WORLD ITSELF, SO THE UPDATE CAN RUN ON ANOTHER THREAD (SEE UpdateThread.h)
+
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <math.h>
+
+#include "Camera.h"
+#include "InputState.h"
+#include "FixedTimestep.h"
+#include "MotionState.h"
+#include "EntityStore.h"
+#include "EntitySystems.h"
+#include "JobSystem.h"
+#include "SpatialHash.h"
+#include "StaticBvh.h"
+#include "RenderSnapshot.h"
+
+// the lamp or Sven can be picked up while the view ray passes this close to them
+const float PICKUP_AIM_RADIUS = 0.5f;
+
+class World
+{
+public:
+	// the game logic runs in fixed ticks of 1/60 s, however fast frames are rendered
+	static const unsigned int TICKS_PER_SECOND = 60;
+
+	// mobs handed to one job when the creature systems are spread over threads, a multiple of 4 for the SSE2 chase
+	static const size_t MOBS_PER_JOB = 2048;
+
+	// the ground is 20 x 20 (bakeGround() in "Source.cpp"), the proximity grids cut it into cells of 1 x 1,
+	// about the largest pickup or catch distance
+	static const unsigned int GRID_BUCKETS = 512;
+
+	// INITIAL POSITION OF CAMERA IN WORLD SPACE
+	Camera camera;
+
+	// INITIAL POSITION OF LAMP IN WORLD SPACE
+	glm::vec3 lightPos;
+
+	// INITIAL POSITION OF SVEN IN WORLD SPACE
+	glm::vec3 svenPos;
+
+	// INITIAL POSITION OF PORTAL IN WORLD SPACE
+	glm::vec3 portalPos;
+
+	// the chasing creatures (water sheep, zombie and any extra mobs), updated every tick
+	EntityStore mobs;
+
+	// the trees, they never move and are baked into the static scene at startup
+	EntityStore trees;
+
+	// is the player holding the object?
+	bool holdLamp;
+	bool holdSven;
+
+	// toggle for orthographic/perspective projection
+	bool orthographicToggle;
+
+	// toggle for batching cubes into instanced draw calls
+	bool instancedToggle;
+
+	// toggle for drawing the static scene from its baked mesh instead of cube by cube
+	bool staticBatchToggle;
+
+	// toggle for printing OpenGL state change counters
+	bool statsToggle;
+
+	// toggles for object interaction
+	bool lampIsClose;
+	bool svenIsClose;
+	bool gameIsHorror;
+	bool gameIsLost;
+	bool gameIsWon;
+
+	// is the scene dark?
+	bool isDark;
+
+	// is the player in the air?
+	bool isJump;
+	// position of camera during jump
+	float POSITION_JUMP;
+	// jump time of player
+	float TIME_JUMP;
+
+	// initial values for lighting
+	float quadraticAtten;
+	float linearAtten;
+
+	// set by processInput() when the player quits
+	bool quitGame;
+
+	World() :
+		camera(glm::vec3(0.0f, 0.6f, 9.0f)),
+		lightPos(0.0f, 0.4f, 8.0f),
+		svenPos(-3.5f, 0.35f, -1.0f),
+		portalPos(9.0f, 0.0f, 0.0f),
+		holdLamp(false),
+		holdSven(false),
+		orthographicToggle(false),
+		instancedToggle(true),
+		staticBatchToggle(true),
+		statsToggle(false),
+		lampIsClose(false),
+		svenIsClose(false),
+		gameIsHorror(false),
+		gameIsLost(false),
+		gameIsWon(false),
+		isDark(false),
+		isJump(false),
+		POSITION_JUMP(0.0f),
+		TIME_JUMP(0.0f),
+		quadraticAtten(0.25),
+		linearAtten(0.7),
+		quitGame(false),
+		jobs(NULL),
+		scenery(NULL),
+		mobGrid(1.0f, GRID_BUCKETS),
+		pickupGrid(1.0f, 16),
+		catchRadius(0.0f),
+		timestep(1.0f / TICKS_PER_SECOND, 8),
+		simulationTime(0.0f),
+		gameTime(0.0f),
+		snapMotion(false),
+		LIGHT_DELAY(0),
+		TOGGLE_DELAY(0),
+		PICKUP_DELAY(0),
+		ORTHO_DELAY(0),
+		INSTANCE_DELAY(0),
+		BATCH_DELAY(0),
+		STATS_DELAY(0)
+	{
+		// INITIAL POSITION OF WATER SHEEP IN WORLD SPACE
+		unsigned int waterSheep = mobs.spawn(MODEL_WATER_SHEEP, glm::vec3(-2.5f, 0.35f, -7.0f), PI);
+		mobs.setChase(waterSheep, 0.25f, 0.5f, 0.5f);
+
+		// INITIAL POSITION OF ZOMBIE IN WORLD SPACE
+		unsigned int zombie = mobs.spawn(MODEL_ZOMBIE, glm::vec3(1.0f, 0.0f, 8.0f), PI);
+		mobs.setChase(zombie, 0.25f, 0.5f, 1.0f);
+
+		plantTrees();
+
+		pickupGrid.add(lightPos);
+		pickupGrid.add(svenPos);
+		trackMobs();
+
+		currentMotion = captureMotion();
+		previousMotion = currentMotion;
+	}
+
+	// ADD extraMobs WATER SHEEP THAT CHASE THE PLAYER WITHOUT BEING ABLE TO CATCH THEM, AND extraTrees TREES,
+	// SCATTERED OVER THE GROUND THE SAME WAY EVERY RUN (STRESS TESTS, CALL BEFORE THE STATIC SCENE IS BAKED)
+	void populate(unsigned int extraMobs, unsigned int extraTrees)
+	{
+		// a fixed seed keeps benchmark runs comparable
+		unsigned int seed = 12345;
+		mobs.reserve(mobs.size() + extraMobs);
+		for(unsigned int i = 0; i < extraMobs; i++)
+		{
+			glm::vec3 position(scatter(seed), 0.35f, scatter(seed));
+			unsigned int mob = mobs.spawn(MODEL_WATER_SHEEP, position, PI);
+			mobs.setChase(mob, 0.25f, 0.5f, 0.0f);
+		}
+		mobs.keepPrevious();
+
+		trees.reserve(trees.size() + extraTrees);
+		for(unsigned int i = 0; i < extraTrees; i++)
+			trees.spawn(MODEL_TREE, glm::vec3(scatter(seed), 0.0f, scatter(seed)), 0.0f);
+		trackMobs();
+	}
+
+	// SPREAD THE CREATURE SYSTEMS OVER THE THREADS OF jobs, NULL RUNS THEM ON THE UPDATING THREAD ALONE
+	void setJobSystem(JobSystem *jobs)
+	{
+		this->jobs = jobs;
+	}
+
+	// THE STATIC SCENE'S HIERARCHY, SO PICKUPS CAN'T BE GRABBED THROUGH A TREE OR WALL, NULL IGNORES THE SCENERY
+	void setScenery(const StaticBvh *scenery)
+	{
+		this->scenery = scenery;
+	}
+
+	// ADVANCE THE GAME BY THE TIME SINCE THE LAST FRAME AND DESCRIBE WHAT TO DRAW FOR IT IN frame
+	void update(const InputState &input, float frameTime, RenderSnapshot &frame)
+	{
+		gameTime += frameTime;
+		simulate(input, frameTime);
+		snapshot(frame);
+	}
+
+	// WHAT TO DRAW THIS FRAME, WITH EVERYTHING THAT MOVES PART WAY BETWEEN THE LAST TWO TICKS
+	// frame is filled in place, so its mob arrays keep their memory from one frame to the next
+	void snapshot(RenderSnapshot &frame)
+	{
+		if(snapMotion)
+		{
+			previousMotion = currentMotion;
+			mobs.keepPrevious();
+			snapMotion = false;
+		}
+
+		float alpha = timestep.alpha();
+		frame.motion = blendMotion(previousMotion, currentMotion, alpha);
+
+		size_t mobCount = mobs.size();
+		frame.mobX.resize(mobCount);
+		frame.mobY.resize(mobCount);
+		frame.mobZ.resize(mobCount);
+		frame.mobHeading.resize(mobCount);
+		frame.mobModel.assign(mobs.model.begin(), mobs.model.end());
+		for(size_t i = 0; i < mobCount; i++)
+		{
+			frame.mobX[i] = mobs.previousX[i] + (mobs.x[i] - mobs.previousX[i]) * alpha;
+			frame.mobY[i] = mobs.previousY[i] + (mobs.y[i] - mobs.previousY[i]) * alpha;
+			frame.mobZ[i] = mobs.previousZ[i] + (mobs.z[i] - mobs.previousZ[i]) * alpha;
+			frame.mobHeading[i] = blendAngle(mobs.previousHeading[i], mobs.heading[i], alpha);
+		}
+
+		frame.cameraFront = camera.Front;
+		frame.cameraUp = camera.Up;
+		frame.time = gameTime;
+		frame.holdLamp = holdLamp;
+		frame.holdSven = holdSven;
+		frame.gameIsHorror = gameIsHorror;
+		frame.gameIsLost = gameIsLost;
+		frame.gameIsWon = gameIsWon;
+		frame.isDark = isDark;
+		frame.orthographicToggle = orthographicToggle;
+		frame.instancedToggle = instancedToggle;
+		frame.staticBatchToggle = staticBatchToggle;
+		frame.statsToggle = statsToggle;
+		frame.linearAtten = linearAtten;
+		frame.quadraticAtten = quadraticAtten;
+		frame.quitGame = quitGame;
+	}
+
+private:
+	// optional worker threads for the creature systems, not owned
+	JobSystem *jobs;
+	// boxes of the static scene, not owned
+	const StaticBvh *scenery;
+	// where the creatures and the pickups (lamp, Sven) are, for the catch, pickup and win checks
+	// a mob's id in mobGrid is its index in mobs, the pickups are PICKUP_LAMP and PICKUP_SVEN
+	SpatialHash mobGrid;
+	SpatialHash pickupGrid;
+	enum { PICKUP_LAMP, PICKUP_SVEN };
+	// the largest catch distance of any mob, how far around the player the catch check looks
+	float catchRadius;
+	FixedTimestep timestep;
+	// clock of the tick being simulated
+	float simulationTime;
+	// clock of the rendered frames, drives the purely visual animations
+	float gameTime;
+	// keys held during frames that have not run a tick yet
+	InputState tickInput;
+	// where things were after the last two ticks, frames are drawn between them
+	MotionState previousMotion;
+	MotionState currentMotion;
+	// set when something teleports (reset, game over screen) so it isn't drawn sliding there
+	bool snapMotion;
+
+	// used in updateInput()
+	int LIGHT_DELAY;
+	int TOGGLE_DELAY;
+	int PICKUP_DELAY;
+	int ORTHO_DELAY;
+	int INSTANCE_DELAY;
+	int BATCH_DELAY;
+	int STATS_DELAY;
+
+	// RUN AS MANY FIXED SIMULATION TICKS AS THE TIME SINCE THE LAST FRAME ADDS UP TO
+	void simulate(const InputState &input, float frameTime)
+	{
+		// keys tapped during a frame that runs no tick still reach the next one
+		for(unsigned int i = 0; i < INPUT_KEY_COUNT; i++)
+			tickInput.keys[i] = tickInput.keys[i] || input.keys[i];
+
+		// look around at the frame rate, the simulation picks up the new direction on its next tick
+		if(input.mouseX != 0.0f || input.mouseY != 0.0f)
+			camera.ProcessMouseMovement(input.mouseX, input.mouseY);
+
+		timestep.advance(frameTime);
+		const InputState *keys = &tickInput;
+		bool ticked = false;
+		while(timestep.tick())
+		{
+			previousMotion = currentMotion;
+			mobs.keepPrevious();
+			simulationTime = timestep.time();
+			updateGame(*keys, timestep.stepLength());
+			currentMotion = captureMotion();
+
+			// further ticks of this frame only see the keys that are still held
+			keys = &input;
+			ticked = true;
+		}
+		if(ticked)
+			tickInput.clear();
+	}
+
+	// ONE SIMULATION TICK: INPUT, GAME RULES, HELD OBJECTS, CREATURE AI AND JUMPING
+	void updateGame(const InputState &input, float dt)
+	{
+		// prevent flickering
+		updateInput();
+
+		processInput(input, dt);
+
+		// check game status
+		checkGameStatus();
+
+		// the lamp is being held
+		if(holdLamp)
+		{
+			glm::vec3 tempPosition = camera.Position;
+			glm::vec3 tempFront = camera.Front;
+
+			// floating animation of lamp and light source
+			tempPosition.y = tempPosition.y + sin(simulationTime) / 60;
+			tempFront.y = tempFront.y +sin(simulationTime * 3) / 40;
+
+			// position lamp in front of player
+			lightPos = tempPosition + tempFront;
+
+			// prevent lamp from going below the ground
+			if(lightPos.y <= 0.2)
+			{
+				lightPos.y = 0.2;
+			}
+		}
+		else
+		{
+			// slower floating animation
+			lightPos.y = lightPos.y + sin(simulationTime * 10) / 250;
+			if(lightPos.y <= 0.2)
+			{
+				lightPos.y = 0.2;
+			}
+		}
+
+		// Sven is being held
+		if(holdSven)
+		{
+			glm::vec3 tempPosition = camera.Position;
+			glm::vec3 tempFront = camera.Front;
+
+			svenPos = tempPosition + tempFront;
+			if(svenPos.y <= 0.35)
+			{
+				svenPos.y = 0.35;
+			}
+
+			// turn the game into horror mode
+			gameIsHorror = true;
+		}
+
+		if(gameIsLost || gameIsWon)
+		{
+			// look straight at the game over screen
+			camera.Front = glm::vec3(0.0f, 0.0f, -1.0f);
+			camera.Position.x = 0.0f;
+			camera.Position.z = 0.0f;
+			camera.Pitch = 0.0f;
+			camera.Yaw = -90.0f;
+			orthographicToggle = true;
+			isDark = true;
+			snapMotion = true;
+		}
+		else
+		{
+			// the creatures only chase the player while the world is shown
+			updateMobs(dt);
+		}
+
+		/*
+			SOURCE(S):
+				https://www.gamedev.net/forums/topic/490713-jump-formula/
+		*/
+		// if the player is jumping, perform gravity calculations
+		if(isJump)
+		{
+			float gravity = -6.0;
+			camera.Position.y = POSITION_JUMP + 6 * (2 * TIME_JUMP + gravity * pow(TIME_JUMP, 2));
+
+			// the player is falling
+			if((camera.Position.y < POSITION_JUMP) && TIME_JUMP > 0)
+			{
+				isJump = false;
+				camera.Position.y = POSITION_JUMP;
+			}
+		}
+	}
+
+	// CHASE AND MOVE EVERY CREATURE, EACH JOB TAKES ITS OWN SLICE OF THE ENTITY STORE
+	void updateMobs(float dt)
+	{
+		const glm::vec3 player = camera.Position;
+		const bool chasing = gameIsHorror;
+		EntityStore &entities = mobs;
+		runMobJobs([&](size_t first, size_t last)
+		{
+			chaseSystem(entities, first, last, player, chasing);
+			moveSystem(entities, first, last, dt);
+		});
+		trackMobs();
+	}
+
+	// BRING mobGrid UP TO DATE WITH THE ENTITY STORE, ADDING ANY NEW MOBS
+	// (one thread, but a mob that stays inside its cell costs a compare)
+	void trackMobs()
+	{
+		for(size_t i = 0; i < mobs.size(); i++)
+		{
+			if(i < mobGrid.size())
+			{
+				mobGrid.move(i, mobs.position(i));
+			}
+			else
+			{
+				mobGrid.add(mobs.position(i));
+				catchRadius = std::max(catchRadius, mobs.catchDistance[i]);
+			}
+		}
+	}
+
+	// HAS ANY CREATURE CAUGHT THE PLAYER?
+	bool mobCaughtPlayer() const
+	{
+		const EntityStore &entities = mobs;
+		return mobGrid.query(camera.Position, catchRadius, [&](unsigned int mob, float distance)
+		{
+			return entities.catchDistance[mob] > 0.0f && distance <= entities.catchDistance[mob];
+		});
+	}
+
+	// IS THE PLAYER LOOKING AT position? THE VIEW RAY HAS TO PASS WITHIN PICKUP_AIM_RADIUS OF IT
+	// WITHOUT HITTING THE STATIC SCENE FIRST
+	bool aimingAt(const glm::vec3 &position) const
+	{
+		// where the ray comes closest to position, camera.Front is unit length
+		float along = glm::dot(position - camera.Position, camera.Front);
+		if(along < 0.0f)
+			along = 0.0f;
+		if(glm::length(camera.Position + along * camera.Front - position) > PICKUP_AIM_RADIUS)
+			return false;
+
+		float distance;
+		unsigned int cube;
+		return !scenery || !scenery->raycast(camera.Position, camera.Front, along, distance, cube);
+	}
+
+	// IS THIS PICKUP WITHIN radius OF center?
+	bool pickupNear(unsigned int pickup, const glm::vec3 &center, float radius) const
+	{
+		return pickupGrid.query(center, radius, [&](unsigned int id, float)
+		{
+			return id == pickup;
+		});
+	}
+
+	// call body(first, last) over every mob, on the job system when there is one
+	template<class Body>
+	void runMobJobs(const Body &body)
+	{
+		if(jobs)
+			jobs->parallelFor(0, mobs.size(), MOBS_PER_JOB, body);
+		else
+			body(0, mobs.size());
+	}
+
+	// WHERE EVERYTHING THAT MOVES IS RIGHT NOW
+	MotionState captureMotion()
+	{
+		MotionState motion;
+		motion.cameraPosition = camera.Position;
+		motion.lightPosition = lightPos;
+		motion.svenPosition = svenPos;
+		return motion;
+	}
+
+	// REACT TO THE KEYS HELD DURING A SIMULATION TICK
+	void processInput(const InputState &input, float dt)
+	{
+		// exit the game
+		if(input.down(KEY_ESCAPE))
+		{
+			quitGame = true;
+		}
+
+		// exit the game
+		if(input.down(KEY_R))
+		{
+			resetGame();
+		}
+
+		// jump upwards
+		if(input.down(KEY_SPACE) && !isJump)
+		{
+			TIME_JUMP = 0;
+			isJump = true;
+			POSITION_JUMP = camera.Position.y;
+		}
+
+		// move forwards
+		if(input.down(KEY_W))
+		{
+			camera.ProcessKeyboard(FORWARD, dt, isJump);
+			moveObject();
+		}
+		// move backwards
+		if(input.down(KEY_S))
+		{
+			camera.ProcessKeyboard(BACKWARD, dt, isJump);
+			moveObject();
+		}
+
+		// move to the left
+		if(input.down(KEY_A))
+		{
+			camera.ProcessKeyboard(LEFT, dt, isJump);
+			moveObject();
+		}
+		
+		// move to the right
+		if(input.down(KEY_D))
+		{
+			camera.ProcessKeyboard(RIGHT, dt, isJump);
+			moveObject();
+		}
+	    
+		// interact with lamp 
+		if(input.down(KEY_F) && PICKUP_DELAY == 0)
+		{
+			PICKUP_DELAY = 20;
+			checkLampDistance();
+		
+			if(lampIsClose && !holdLamp)
+				holdLamp = true;
+			else if(holdLamp)
+				holdLamp = false;
+		}
+
+		// interact with Sven 
+		if(input.down(KEY_E) && PICKUP_DELAY == 0)
+		{
+			PICKUP_DELAY = 20;
+			checkSvenDistance();
+		
+			if(svenIsClose && !holdSven)
+				holdSven = true;
+			else if(holdSven)
+				holdSven = false;
+		}
+
+		// toggle type of projection
+		if(input.down(KEY_P) && ORTHO_DELAY == 0)
+		{
+			ORTHO_DELAY = 20;
+			if(!orthographicToggle)
+				orthographicToggle = true;
+			else
+				orthographicToggle = false;
+		}
+
+	    	// toggle instanced/per-cube rendering
+		if(input.down(KEY_I) && INSTANCE_DELAY == 0)
+		{
+			INSTANCE_DELAY = 20;
+			if(!instancedToggle)
+				instancedToggle = true;
+			else
+				instancedToggle = false;
+		}
+
+		// toggle baked/per-cube static scene
+		if(input.down(KEY_B) && BATCH_DELAY == 0)
+		{
+			BATCH_DELAY = 20;
+			if(!staticBatchToggle)
+				staticBatchToggle = true;
+			else
+				staticBatchToggle = false;
+		}
+
+		// toggle printing of OpenGL state change counters
+		if(input.down(KEY_M) && STATS_DELAY == 0)
+		{
+			STATS_DELAY = 20;
+			if(!statsToggle)
+				statsToggle = true;
+			else
+				statsToggle = false;
+		}
+
+	    	// toggle dark or bright scenery 
+		if(input.down(KEY_O) && LIGHT_DELAY == 0)
+		{
+			LIGHT_DELAY = 20;
+			if(!isDark)
+				isDark = true;
+			else
+				isDark = false;
+		}
+
+		// increase attenuation of light source
+		if(input.down(KEY_L))
+		{
+			linearAtten /= 1.2;
+			quadraticAtten /= 1.2*1.2;
+	        
+	        if(linearAtten <= 0.05f)
+				linearAtten = 0.05f;
+
+			if(quadraticAtten <= 0.0075)
+				quadraticAtten = 0.0075;
+		}
+
+		// decrease attenuation of light source
+		if(input.down(KEY_K))
+		{
+			linearAtten *= 1.2;
+			quadraticAtten *= 1.2*1.2;
+
+			if(linearAtten >= 0.8)
+				linearAtten = 0.8;
+
+			if(quadraticAtten >= 2.0)
+				quadraticAtten = 2.0;
+		}
+	}
+
+	// RESET THE GAME
+	void resetGame()
+	{
+		// RESET CORE GAME TOGGLES
+		holdSven = false;
+		holdLamp = false;
+		gameIsLost = false;
+		gameIsWon = false;
+		gameIsHorror = false;
+		lampIsClose = false;
+		svenIsClose = false;
+		orthographicToggle = false;
+		isDark = false;
+
+		// RESET POSITION OF CAMERA IN WORLD SPACE
+		camera.Position = glm::vec3(0.0f, 0.6f, 9.0f);
+		camera.WorldUp = glm::vec3(0.0f, 1.0f, 0.0f);
+		camera.Front = glm::vec3(0.0f, 0.0f, -1.0f);
+
+		// RESET POSITION OF LAMP IN WORLD SPACE
+		lightPos = glm::vec3(0.0f, 0.4f, 8.0f);
+
+		// RESET POSITION OF SVEN IN WORLD SPACE
+		svenPos = glm::vec3(-3.5f, 0.35f, -1.0f);
+
+		// RESET POSITION OF WATER SHEEP, ZOMBIE AND ANY EXTRA MOBS IN WORLD SPACE
+		mobs.respawn();
+		trackMobs();
+
+		// RESET POSITION OF PORTAL IN WORLD SPACE
+		portalPos = glm::vec3(9.0f, 0.0f, 0.0f);
+
+		// don't draw everything sliding back to where it started
+		snapMotion = true;
+	}
+
+	// CHECK IF GAME IS LOST OR WON
+	void checkGameStatus()
+	{
+		// has the zombie or water sheep caught the player?
+		if(gameIsHorror)
+		{
+			if(mobCaughtPlayer())
+			{
+				gameIsLost = true;
+			}
+
+			// has the player saved Sven?
+			pickupGrid.move(PICKUP_SVEN, svenPos);
+			if(pickupNear(PICKUP_SVEN, portalPos, 1.0f))
+			{
+				gameIsWon = true;
+				gameIsLost = false;
+			}
+		}
+	}
+
+	// CHECK DISTANCE OF LAMP TO PLAYER
+	void checkLampDistance()
+	{
+		// is the lamp close enough to be picked up, and is the player looking at it?
+		pickupGrid.move(PICKUP_LAMP, lightPos);
+		if(pickupNear(PICKUP_LAMP, camera.Position, 1.2f) && aimingAt(lightPos))
+		{
+			lampIsClose = true;
+		}
+		else
+		{
+			lampIsClose = false;
+		}
+	}
+
+	// CHECK DISTANCE OF SVEN TO PLAYER
+	void checkSvenDistance()
+	{
+		// is Sven close enough to be picked up, and is the player looking at Sven?
+		pickupGrid.move(PICKUP_SVEN, svenPos);
+		if(pickupNear(PICKUP_SVEN, camera.Position, 1.2f) && aimingAt(svenPos))
+		{
+			svenIsClose = true;
+		}
+		else
+		{
+			svenIsClose = false;
+		}
+	}
+
+	// TRACK LAMP WITH CAMERA MOVEMENT
+	void moveObject()
+	{
+		if(holdLamp)
+		{
+			glm::vec3 tempPosition = camera.Position;
+			glm::vec3 tempFront = camera.Front;
+
+			tempPosition.y = tempPosition.y + +sin(simulationTime)/10;
+			tempFront.y = tempFront.y + +sin(simulationTime+simulationTime+ simulationTime + simulationTime)/10;
+			lightPos = tempPosition + tempFront;		
+		}
+
+		if(holdSven)
+		{
+			glm::vec3 tempPosition = camera.Position;
+			glm::vec3 tempFront = camera.Front;
+				
+			svenPos = tempPosition + tempFront;
+		}
+	}
+
+	/*
+	    SOURCE(s):
+		Antoni Liang, Curtin University
+	*/
+	// PREVENT FLICKERING WITH INPUT
+	void updateInput()
+	{
+		if(LIGHT_DELAY > 0)
+		{
+			LIGHT_DELAY -= 1.1;
+		}
+
+		if(TIME_JUMP < 0.5f)
+		{
+			TIME_JUMP += 0.01;
+		}
+
+		if(TOGGLE_DELAY > 0)
+		{
+			TOGGLE_DELAY -= 1;
+		}
+		
+		if(PICKUP_DELAY > 0)
+		{
+			PICKUP_DELAY -= 1;
+		}
+		
+		if(ORTHO_DELAY > 0)
+		{
+			ORTHO_DELAY -= 1;
+		}
+
+		if(INSTANCE_DELAY > 0)
+		{
+			INSTANCE_DELAY -= 1;
+		}
+
+		if(BATCH_DELAY > 0)
+		{
+			BATCH_DELAY -= 1;
+		}
+
+		if(STATS_DELAY > 0)
+		{
+			STATS_DELAY -= 1;
+		}
+	}
+
+	// PLANT THE TREES OF THE MAP
+	void plantTrees()
+	{
+		// define positions of the trees
+		glm::vec3 treePositions[] =
+		{
+			glm::vec3(1.0f,0.0f,1.0f),
+			glm::vec3(1.0f,0.0f,-1.0f),
+			glm::vec3(-1.0f,0.0f,1.0f),
+			glm::vec3(-1.0f,0.0f,-1.0f),
+			glm::vec3(2.0f,0.0f,2.0f),
+			glm::vec3(2.0f,0.0f,-2.0f),
+			glm::vec3(-2.0f,0.0f,2.0f),
+			glm::vec3(-2.0f,0.0f,-2.0f),
+			glm::vec3(4.0f,0.0f,4.0f),
+			glm::vec3(4.0f,0.0f,-4.0f),
+			glm::vec3(-4.0f,0.0f,4.0f),
+			glm::vec3(-4.0f,0.0f,-4.0f),
+			glm::vec3(2.0f,0.0f,4.0f),
+			glm::vec3(2.0f,0.0f,-4.0f),
+			glm::vec3(-2.0f,0.0f,4.0f),
+			glm::vec3(-2.0f,0.0f,-4.0f),
+			glm::vec3(4.0f,0.0f,2.0f),
+			glm::vec3(4.0f,0.0f,-2.0f),
+			glm::vec3(-4.0f,0.0f,2.0f),
+			glm::vec3(-4.0f,0.0f,-2.0f),
+			glm::vec3(8.0f,0.0f,8.0f),
+			glm::vec3(8.0f,0.0f,-8.0f),
+			glm::vec3(-8.0f,0.0f,8.0f),
+			glm::vec3(-8.0f,0.0f,-8.0f),
+			glm::vec3(6.0f,0.0f,8.0f),
+			glm::vec3(6.0f,0.0f,-8.0f),
+			glm::vec3(-6.0f,0.0f,8.0f),
+			glm::vec3(-6.0f,0.0f,-8.0f),
+			glm::vec3(4.0f,0.0f,8.0f),
+			glm::vec3(4.0f,0.0f,-8.0f),
+			glm::vec3(-4.0f,0.0f,8.0f),
+			glm::vec3(-4.0f,0.0f,-8.0f),
+			glm::vec3(2.0f,0.0f,8.0f),
+			glm::vec3(2.0f,0.0f,-8.0f),
+			glm::vec3(-2.0f,0.0f,8.0f),
+			glm::vec3(-2.0f,0.0f,-8.0f)
+		};
+
+		int numberOfTrees = sizeof(treePositions)/sizeof(treePositions[0]);
+		for(int i = 0; i < numberOfTrees; i++)
+			trees.spawn(MODEL_TREE, treePositions[i], 0.0f);
+	}
+
+	// A REPEATABLE PSEUDO-RANDOM COORDINATE INSIDE THE WALLS
+	static float scatter(unsigned int &seed)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		return ((seed >> 8) / 16777216.0f) * 18.0f - 9.0f;
+	}
+};
+#endif
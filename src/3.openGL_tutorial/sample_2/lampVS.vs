@@ -5,12 +5,33 @@
 
 #version 330 core
 layout(location = 0) in vec3 aPos;
+// per-instance model matrix, only read when drawing instanced
+layout(location = 3) in mat4 aInstanceModel;
+
+struct Light {
+	vec3 position;
+	float constant;
+	vec3 ambient;
+	float linear;
+	vec3 diffuse;
+	float quadratic;
+	vec3 specular;
+};
+
+// per-frame camera and light state, shared with every other program (see FrameData.h)
+layout(std140) uniform FrameData
+{
+	mat4 projection;
+	mat4 view;
+	vec3 viewPos;
+	Light light;
+};
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform bool instanced;
 
 void main()
 {
-	gl_Position = projection * view * model * vec4(aPos, 1.0);
+	mat4 world = instanced ? aInstanceModel : model;
+	gl_Position = projection * view * world * vec4(aPos, 1.0);
 }
@@ -12,25 +12,30 @@ struct Material {
 	float shininess;
 };
 
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoords;
+
 struct Light {
 	vec3 position;
-
-	vec3 ambient;
-	vec3 diffuse;
-	vec3 specular;
-
 	float constant;
+	vec3 ambient;
 	float linear;
+	vec3 diffuse;
 	float quadratic;
+	vec3 specular;
 };
 
-in vec3 FragPos;
-in vec3 Normal;
-in vec2 TexCoords;
+// per-frame camera and light state, shared with every other program (see FrameData.h)
+layout(std140) uniform FrameData
+{
+	mat4 projection;
+	mat4 view;
+	vec3 viewPos;
+	Light light;
+};
 
-uniform vec3 viewPos;
 uniform Material material;
-uniform Light light;
 
 void main()
 {
@@ -7,19 +7,44 @@
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoords;
+// per-instance model and normal matrices, only read when drawing instanced
+layout(location = 3) in mat4 aInstanceModel;
+layout(location = 7) in mat3 aInstanceNormal;
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
 
+struct Light {
+	vec3 position;
+	float constant;
+	vec3 ambient;
+	float linear;
+	vec3 diffuse;
+	float quadratic;
+	vec3 specular;
+};
+
+// per-frame camera and light state, shared with every other program (see FrameData.h)
+layout(std140) uniform FrameData
+{
+	mat4 projection;
+	mat4 view;
+	vec3 viewPos;
+	Light light;
+};
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// inverse transpose of the model matrix, computed on the CPU
+uniform mat3 normalMatrix;
+uniform bool instanced;
 
 void main()
 {
-	FragPos = vec3(model * vec4(aPos, 1.0));
-	Normal = mat3(transpose(inverse(model))) * aNormal;
+	mat4 world = instanced ? aInstanceModel : model;
+	mat3 normalWorld = instanced ? aInstanceNormal : normalMatrix;
+	FragPos = vec3(world * vec4(aPos, 1.0));
+	Normal = normalWorld * aNormal;
 	TexCoords = aTexCoords;
 
 	gl_Position = projection * view * vec4(FragPos, 1.0);